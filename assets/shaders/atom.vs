@@ -0,0 +1,43 @@
+#version 330 core
+
+// unit sphere mesh
+in vec3 position;
+in vec3 normal;
+
+// per-atom data (one entry per instance)
+in vec3 instance_position;
+in float instance_radius;
+in vec4 instance_color;
+
+out vec3 vertex_direction_eyespace;
+out vec3 lightdirection_eyespace;
+out vec3 normal_eyespace;
+out vec4 vertex_color;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 mvp;
+uniform vec3 light_pos;
+
+void main() {
+    // place the unit sphere at the atom position with the atom radius
+    vec4 position_modelspace = vec4(instance_position + instance_radius * position, 1.0);
+
+    // output position of the vertex
+    gl_Position = mvp * position_modelspace;
+
+    // calculate vertex-to-camera direction in eye space
+    vec3 position_eyespace = (view * model * position_modelspace).xyz;
+    vertex_direction_eyespace = vec3(0,0,0) - position_eyespace;
+
+    // calculate light-to-vertex direction in eye space
+    vec3 position_worldspace = (model * position_modelspace).xyz;
+    vec3 light_direction_worldspace = light_pos - position_worldspace.xyz;
+    lightdirection_eyespace = (view * vec4(light_direction_worldspace, 0.0)).xyz;
+
+    // model and view only contain rotations and translations, hence the
+    // normal can be transformed directly without the inverse transpose
+    normal_eyespace = (view * model * vec4(normal, 0.0)).xyz;
+
+    vertex_color = instance_color;
+}
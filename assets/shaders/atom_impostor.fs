@@ -0,0 +1,83 @@
+#version 330 core
+
+in vec3 ray_near;
+in vec3 ray_far;
+flat in vec3 sphere_center;
+flat in float sphere_radius;
+flat in vec4 vertex_color;
+
+uniform mat4  view;
+uniform mat4  projection;
+uniform vec3  light_pos;             // light position in world space
+uniform vec3  light_color;           // light intensity/color
+uniform float diffuse_strength;
+uniform float ambient_strength;
+uniform float specular_strength;
+uniform float shininess;             // specular exponent (e.g. 16–128)
+uniform float edge_strength;
+uniform float edge_power;
+uniform int camera_mode;
+
+out vec4 fragColor;
+
+void main()
+{
+    // --- Ray-sphere intersection in eye space ---
+    vec3 ro = ray_near;
+    vec3 rd = normalize(ray_far - ray_near);
+    vec3 oc = ro - sphere_center;
+    float b = dot(oc, rd);
+    float c = dot(oc, oc) - sphere_radius * sphere_radius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0) {
+        discard;
+    }
+    float t = -b - sqrt(discriminant);
+    if (t < 0.0) {
+        discard;
+    }
+
+    vec3 p = ro + t * rd;
+
+    // write the depth of the intersection point
+    vec4 clip = projection * vec4(p, 1.0);
+    gl_FragDepth = (clip.z / clip.w) * 0.5 + 0.5;
+
+    // --- Normalize inputs ---
+    vec3 N = (p - sphere_center) / sphere_radius;
+    vec3 L = normalize((view * vec4(light_pos, 1.0)).xyz - p);
+    vec3 V = normalize(-p);
+    if (camera_mode == 1) {
+        V = vec3(0.0, 0.0, 1.0);
+    }
+
+    // --- Ambient ---
+    vec3 ambient = ambient_strength * light_color;
+
+    // --- Diffuse (Lambert) ---
+    float NdotL = max(dot(N, L), 0.0);
+    vec3 diffuse = diffuse_strength * NdotL * light_color;
+
+    // --- Blinn-Phong specular ---
+    vec3 H = normalize(L + V);   // half-vector
+    float NdotH = max(dot(N, H), 0.0);
+    float spec = pow(NdotH, shininess);
+
+    // Energy-aware specular reduction
+    vec3 specular = specular_strength * spec * light_color * (1.0 - vertex_color.rgb);
+
+    // Combine lighting
+    vec3 result = (ambient + diffuse) * vertex_color.rgb + specular;
+
+    // ================= EDGE DARKENING =================
+    float rim = 1.0 - max(dot(N, V), 0.0);
+    rim = pow(rim, edge_power);
+
+    result *= (1.0 - rim * edge_strength);
+    // ==================================================
+
+    // Gamma correction (important!)
+    result = pow(result, vec3(1.0/2.2));
+
+    fragColor = vec4(result, vertex_color.a);
+}
@@ -0,0 +1,67 @@
+#version 330 core
+
+// corner of the screen-aligned quad in [-1,1]^2
+in vec2 corner;
+
+// per-atom data (one entry per instance)
+in vec3 instance_position;
+in float instance_radius;
+in vec4 instance_color;
+
+out vec3 ray_near;                   // eye-space ray origin on the near plane
+out vec3 ray_far;                    // eye-space ray end point on the far plane
+flat out vec3 sphere_center;         // eye-space sphere center
+flat out float sphere_radius;
+flat out vec4 vertex_color;
+
+uniform mat4 modelview;
+uniform mat4 projection;
+uniform mat4 projection_inverse;
+
+vec3 unproject(vec3 ndc) {
+    vec4 p = projection_inverse * vec4(ndc, 1.0);
+    return p.xyz / p.w;
+}
+
+void main() {
+    vec3 center = (modelview * vec4(instance_position, 1.0)).xyz;
+
+    // determine the screen-space bounding rectangle of the sphere by
+    // projecting the corners of its eye-space bounding box
+    vec2 ndc_min = vec2(1e30);
+    vec2 ndc_max = vec2(-1e30);
+    bool behind_camera = false;
+    for (int i = 0; i < 8; i++) {
+        vec3 offset = vec3((i & 1) == 0 ? -1.0 : 1.0,
+                           (i & 2) == 0 ? -1.0 : 1.0,
+                           (i & 4) == 0 ? -1.0 : 1.0);
+        vec4 clip = projection * vec4(center + instance_radius * offset, 1.0);
+        if (clip.w <= 0.0) {
+            behind_camera = true;
+            break;
+        }
+        ndc_min = min(ndc_min, clip.xy / clip.w);
+        ndc_max = max(ndc_max, clip.xy / clip.w);
+    }
+    if (behind_camera) {
+        ndc_min = vec2(-1.0);
+        ndc_max = vec2(1.0);
+    }
+
+    vec2 ndc = mix(ndc_min, ndc_max, corner * 0.5 + 0.5);
+
+    // place the quad at the front of the sphere; the exact depth is
+    // written by the fragment shader
+    vec4 front = projection * vec4(center + vec3(0.0, 0.0, instance_radius), 1.0);
+    float depth = behind_camera ? -1.0 : clamp(front.z / front.w, -1.0, 1.0);
+
+    // the quad is emitted with w = 1 such that the ray end points, which
+    // are affine in normalized device coordinates, interpolate linearly
+    gl_Position = vec4(ndc, depth, 1.0);
+    ray_near = unproject(vec3(ndc, -1.0));
+    ray_far = unproject(vec3(ndc, 1.0));
+
+    sphere_center = center;
+    sphere_radius = instance_radius;
+    vertex_color = instance_color;
+}
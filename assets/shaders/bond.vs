@@ -0,0 +1,58 @@
+#version 330 core
+
+// unit cylinder mesh (radius 1, height 1)
+in vec3 position;
+in vec3 normal;
+
+// per-bond data; every bond is drawn as two instances, one per colored half
+in vec3 bond_start;
+in vec3 bond_end;
+in vec4 color_start;
+in vec4 color_end;
+
+out vec3 vertex_direction_eyespace;
+out vec3 lightdirection_eyespace;
+out vec3 normal_eyespace;
+out vec4 vertex_color;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 mvp;
+uniform vec3 light_pos;
+uniform float bond_radius;
+
+void main() {
+    // build an orthonormal basis with w along the bond axis
+    vec3 axis = bond_end - bond_start;
+    float bond_length = length(axis);
+    vec3 w = bond_length > 1e-6 ? axis / bond_length : vec3(0.0, 0.0, 1.0);
+    vec3 helper = abs(w.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    vec3 u = normalize(cross(helper, w));
+    vec3 v = cross(w, u);
+
+    // even instances draw the first half, odd instances the second half
+    int bond_half = gl_InstanceID & 1;
+    vec3 origin = bond_start + 0.5 * float(bond_half) * axis;
+
+    vec4 position_modelspace = vec4(origin +
+                                    bond_radius * (position.x * u + position.y * v) +
+                                    0.5 * bond_length * position.z * w, 1.0);
+    vec3 normal_modelspace = normal.x * u + normal.y * v;
+
+    // output position of the vertex
+    gl_Position = mvp * position_modelspace;
+
+    // calculate vertex-to-camera direction in eye space
+    vec3 position_eyespace = (view * model * position_modelspace).xyz;
+    vertex_direction_eyespace = vec3(0,0,0) - position_eyespace;
+
+    // calculate light-to-vertex direction in eye space
+    vec3 position_worldspace = (model * position_modelspace).xyz;
+    vec3 light_direction_worldspace = light_pos - position_worldspace.xyz;
+    lightdirection_eyespace = (view * vec4(light_direction_worldspace, 0.0)).xyz;
+
+    // model and view only contain rotations and translations
+    normal_eyespace = (view * model * vec4(normal_modelspace, 0.0)).xyz;
+
+    vertex_color = bond_half == 0 ? color_start : color_end;
+}
@@ -0,0 +1,112 @@
+#version 330 core
+
+in vec3 ray_near;
+in vec3 ray_far;
+flat in vec3 cylinder_start;
+flat in vec3 cylinder_end;
+flat in vec4 vertex_color;
+
+uniform mat4  view;
+uniform mat4  projection;
+uniform float bond_radius;
+uniform vec3  light_pos;             // light position in world space
+uniform vec3  light_color;           // light intensity/color
+uniform float diffuse_strength;
+uniform float ambient_strength;
+uniform float specular_strength;
+uniform float shininess;             // specular exponent (e.g. 16–128)
+uniform float edge_strength;
+uniform float edge_power;
+uniform int camera_mode;
+
+out vec4 fragColor;
+
+// Intersect a ray with a capped cylinder running from pa to pb with radius
+// ra. Returns the distance along the ray and the surface normal or a
+// negative distance when there is no intersection.
+// See: https://iquilezles.org/articles/intersectors/
+vec4 intersect_cylinder(vec3 ro, vec3 rd, vec3 pa, vec3 pb, float ra) {
+    vec3 ba = pb - pa;
+    vec3 oc = ro - pa;
+    float baba = dot(ba, ba);
+    float bard = dot(ba, rd);
+    float baoc = dot(ba, oc);
+    float k2 = baba - bard * bard;
+    float k1 = baba * dot(oc, rd) - baoc * bard;
+    float k0 = baba * dot(oc, oc) - baoc * baoc - ra * ra * baba;
+    float h = k1 * k1 - k2 * k0;
+    if (h < 0.0) {
+        return vec4(-1.0);
+    }
+    h = sqrt(h);
+
+    // body
+    float t = (-k1 - h) / k2;
+    float y = baoc + t * bard;
+    if (y > 0.0 && y < baba) {
+        return vec4(t, (oc + t * rd - ba * y / baba) / ra);
+    }
+
+    // caps
+    t = (((y < 0.0) ? 0.0 : baba) - baoc) / bard;
+    if (abs(k1 + k2 * t) < h) {
+        return vec4(t, ba * sign(y) / sqrt(baba));
+    }
+
+    return vec4(-1.0);
+}
+
+void main()
+{
+    // --- Ray-cylinder intersection in eye space ---
+    vec3 ro = ray_near;
+    vec3 rd = normalize(ray_far - ray_near);
+    vec4 hit = intersect_cylinder(ro, rd, cylinder_start, cylinder_end, bond_radius);
+    if (hit.x < 0.0) {
+        discard;
+    }
+
+    vec3 p = ro + hit.x * rd;
+
+    // write the depth of the intersection point
+    vec4 clip = projection * vec4(p, 1.0);
+    gl_FragDepth = (clip.z / clip.w) * 0.5 + 0.5;
+
+    // --- Normalize inputs ---
+    vec3 N = normalize(hit.yzw);
+    vec3 L = normalize((view * vec4(light_pos, 1.0)).xyz - p);
+    vec3 V = normalize(-p);
+    if (camera_mode == 1) {
+        V = vec3(0.0, 0.0, 1.0);
+    }
+
+    // --- Ambient ---
+    vec3 ambient = ambient_strength * light_color;
+
+    // --- Diffuse (Lambert) ---
+    float NdotL = max(dot(N, L), 0.0);
+    vec3 diffuse = diffuse_strength * NdotL * light_color;
+
+    // --- Blinn-Phong specular ---
+    vec3 H = normalize(L + V);   // half-vector
+    float NdotH = max(dot(N, H), 0.0);
+    float spec = pow(NdotH, shininess);
+
+    // Energy-aware specular reduction
+    vec3 specular = specular_strength * spec * light_color * (1.0 - vertex_color.rgb);
+
+    // Combine lighting
+    vec3 result = (ambient + diffuse) * vertex_color.rgb + specular;
+
+    // ================= EDGE DARKENING =================
+    float rim = 1.0 - max(dot(N, V), 0.0);
+    rim = pow(rim, edge_power);
+
+    result *= (1.0 - rim * edge_strength);
+    // ==================================================
+
+    // Gamma correction (important!)
+    result = pow(result, vec3(1.0/2.2));
+
+    fragColor = vec4(result, vertex_color.a);
+}
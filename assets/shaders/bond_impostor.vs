@@ -0,0 +1,75 @@
+#version 330 core
+
+// corner of the screen-aligned quad in [-1,1]^2
+in vec2 corner;
+
+// per-bond data; every bond is drawn as two instances, one per colored half
+in vec3 bond_start;
+in vec3 bond_end;
+in vec4 color_start;
+in vec4 color_end;
+
+out vec3 ray_near;                   // eye-space ray origin on the near plane
+out vec3 ray_far;                    // eye-space ray end point on the far plane
+flat out vec3 cylinder_start;        // eye-space start of the bond half
+flat out vec3 cylinder_end;          // eye-space end of the bond half
+flat out vec4 vertex_color;
+
+uniform mat4 modelview;
+uniform mat4 projection;
+uniform mat4 projection_inverse;
+uniform float bond_radius;
+
+vec3 unproject(vec3 ndc) {
+    vec4 p = projection_inverse * vec4(ndc, 1.0);
+    return p.xyz / p.w;
+}
+
+void main() {
+    // even instances draw the first half, odd instances the second half
+    int bond_half = gl_InstanceID & 1;
+    vec3 start = (modelview * vec4(bond_start, 1.0)).xyz;
+    vec3 end = (modelview * vec4(bond_end, 1.0)).xyz;
+    vec3 middle = 0.5 * (start + end);
+    vec3 pa = bond_half == 0 ? start : middle;
+    vec3 pb = bond_half == 0 ? middle : end;
+
+    // determine the screen-space bounding rectangle of the cylinder by
+    // projecting the corners of its eye-space bounding box
+    vec3 box_min = min(pa, pb) - vec3(bond_radius);
+    vec3 box_max = max(pa, pb) + vec3(bond_radius);
+    vec2 ndc_min = vec2(1e30);
+    vec2 ndc_max = vec2(-1e30);
+    bool behind_camera = false;
+    for (int i = 0; i < 8; i++) {
+        vec3 p = vec3((i & 1) == 0 ? box_min.x : box_max.x,
+                      (i & 2) == 0 ? box_min.y : box_max.y,
+                      (i & 4) == 0 ? box_min.z : box_max.z);
+        vec4 clip = projection * vec4(p, 1.0);
+        if (clip.w <= 0.0) {
+            behind_camera = true;
+            break;
+        }
+        ndc_min = min(ndc_min, clip.xy / clip.w);
+        ndc_max = max(ndc_max, clip.xy / clip.w);
+    }
+    if (behind_camera) {
+        ndc_min = vec2(-1.0);
+        ndc_max = vec2(1.0);
+    }
+
+    vec2 ndc = mix(ndc_min, ndc_max, corner * 0.5 + 0.5);
+
+    // place the quad at the front of the bounding box; the exact depth is
+    // written by the fragment shader
+    vec4 front = projection * vec4(0.5 * (box_min.xy + box_max.xy), box_max.z, 1.0);
+    float depth = behind_camera ? -1.0 : clamp(front.z / front.w, -1.0, 1.0);
+
+    gl_Position = vec4(ndc, depth, 1.0);
+    ray_near = unproject(vec3(ndc, -1.0));
+    ray_far = unproject(vec3(ndc, 1.0));
+
+    cylinder_start = pa;
+    cylinder_end = pb;
+    vertex_color = bond_half == 0 ? color_start : color_end;
+}
@@ -0,0 +1,121 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#include "abof_frame_provider.h"
+
+/**
+ * @brief AbofFrameProvider constructor
+ * @param _reader reader of the file
+ * @param _max_records maximum number of prefetched frame records
+ */
+AbofFrameProvider::AbofFrameProvider(const std::shared_ptr<const AbofReader>& _reader, size_t _max_records) :
+    reader(_reader),
+    max_records(_max_records) {}
+
+/**
+ * @brief Decode a frame ahead of its use
+ * @param frame_id frame index
+ */
+void AbofFrameProvider::prefetch(size_t frame_id) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        for(const auto& record : this->records) {
+            if(record.first == frame_id) {
+                return;
+            }
+        }
+    }
+
+    auto record = this->decode(frame_id);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->records.emplace_front(frame_id, std::move(record));
+    while(this->records.size() > this->max_records) {
+        this->records.pop_back();
+    }
+}
+
+/**
+ * @brief Load a frame, using the prefetched frame record when available
+ *
+ * The models own rendering resources and are hence created on the calling
+ * thread.
+ *
+ * @param frame_id frame index
+ * @return frame
+ */
+std::shared_ptr<Frame> AbofFrameProvider::load_frame(size_t frame_id) {
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        for(auto it = this->records.begin(); it != this->records.end(); ++it) {
+            if(it->first == frame_id) {
+                auto record = std::move(it->second);
+                this->records.erase(it);
+                lock.unlock();
+                return this->loader.build_frame(std::move(record));
+            }
+        }
+    }
+
+    return this->loader.build_frame(this->decode(frame_id));
+}
+
+/**
+ * @brief Decode a frame record
+ * @param frame_id frame index
+ * @return contents of the frame record
+ */
+ContainerLoader::FrameRecord AbofFrameProvider::decode(size_t frame_id) {
+    const AbofReader::FrameInfo info = this->reader->get_frame_info(frame_id);
+    const auto chunk = this->open_chunk(info.chunk);
+
+    ByteCursor cursor(chunk->data, chunk->size, this->reader->get_path());
+    cursor.seek(info.offset);
+    return this->loader.decode_frame_abo(cursor);
+}
+
+/**
+ * @brief Get a decompressed chunk, re-using the last chunk when possible
+ *
+ * The chunk is decompressed without holding the lock, hence two threads may
+ * occasionally decompress the same chunk.
+ *
+ * @param chunk_id chunk index
+ * @return chunk
+ */
+std::shared_ptr<const AbofFrameProvider::Chunk> AbofFrameProvider::open_chunk(size_t chunk_id) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if(this->last_chunk && this->last_chunk->id == chunk_id) {
+            return this->last_chunk;
+        }
+    }
+
+    auto chunk = std::make_shared<Chunk>();
+    chunk->id = chunk_id;
+    ByteCursor cursor = this->reader->open_chunk(chunk_id, chunk->buffer);
+    chunk->size = cursor.remaining();
+    chunk->data = cursor.view(chunk->size);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->last_chunk = chunk;
+    return chunk;
+}
@@ -0,0 +1,109 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef ABOF_FRAME_PROVIDER_H
+#define ABOF_FRAME_PROVIDER_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "frame_provider.h"
+#include "abof_reader.h"
+#include "container_loader.h"
+
+/**
+ * @brief Frame provider decoding the frames of a seekable (version 3) ABOF
+ *        file on demand
+ *
+ * Prefetched frame records are held until they are loaded, up to a maximum
+ * number of records. The most recently decompressed chunk is retained, such
+ * that consecutive frames in the same chunk are decompressed only once.
+ */
+class AbofFrameProvider : public FrameProvider
+{
+private:
+    /**
+     * @brief Decompressed chunk
+     */
+    struct Chunk {
+        size_t id = 0;
+        std::vector<char> buffer;       // decompressed bytes; empty for uncompressed files
+        const char* data = nullptr;     // start of the frame records
+        size_t size = 0;                // number of bytes of the frame records
+    };
+
+    std::shared_ptr<const AbofReader> reader;
+    ContainerLoader loader;
+
+    std::mutex mutex;                                                   // guards the members below
+    std::shared_ptr<const Chunk> last_chunk;                            // most recently decompressed chunk
+    std::list<std::pair<size_t, ContainerLoader::FrameRecord>> records; // prefetched records, most recent first
+    size_t max_records;                                                 // maximum number of prefetched records
+
+public:
+    /**
+     * @brief AbofFrameProvider constructor
+     * @param _reader reader of the file
+     * @param _max_records maximum number of prefetched frame records
+     */
+    AbofFrameProvider(const std::shared_ptr<const AbofReader>& _reader, size_t _max_records = 16);
+
+    inline size_t get_nr_frames() const override {
+        return this->reader->get_nr_frames();
+    }
+
+    inline std::optional<std::array<float, 6>> get_bounds(size_t frame_id) const override {
+        return this->reader->get_frame_info(frame_id).bounds;
+    }
+
+    /**
+     * @brief Decode a frame ahead of its use
+     * @param frame_id frame index
+     */
+    void prefetch(size_t frame_id) override;
+
+    /**
+     * @brief Load a frame, using the prefetched frame record when available
+     * @param frame_id frame index
+     * @return frame
+     */
+    std::shared_ptr<Frame> load_frame(size_t frame_id) override;
+
+private:
+    /**
+     * @brief Decode a frame record
+     * @param frame_id frame index
+     * @return contents of the frame record
+     */
+    ContainerLoader::FrameRecord decode(size_t frame_id);
+
+    /**
+     * @brief Get a decompressed chunk, re-using the last chunk when possible
+     * @param chunk_id chunk index
+     * @return chunk
+     */
+    std::shared_ptr<const Chunk> open_chunk(size_t chunk_id);
+};
+
+#endif // ABOF_FRAME_PROVIDER_H
@@ -0,0 +1,185 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#include "abof_reader.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <zstd.h>
+
+namespace {
+
+template<typename T>
+T read_le(const char* ptr) {
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+/**
+ * @brief AbofReader constructor, opens a file and reads its header and
+ *        index
+ * @param path path to file
+ */
+AbofReader::AbofReader(const std::string& _path) :
+    path(_path),
+    file(QString::fromStdString(_path)) {
+
+    if (!this->file.open(QIODevice::ReadOnly))
+        throw std::runtime_error("Could not open file: " + this->path);
+
+    // fall back to reading the file when it cannot be mapped
+    this->size = static_cast<size_t>(this->file.size());
+    this->data = reinterpret_cast<const char*>(this->size > 0 ? this->file.map(0, this->size) : nullptr);
+    if (!this->data) {
+        this->contents = this->file.readAll();
+        this->data = this->contents.constData();
+    }
+
+    if (this->size < HEADER_SIZE + TRAILER_SIZE ||
+        read_le<uint16_t>(this->data) != 0 ||
+        std::memcmp(this->data + 2, "ABOF", 4) != 0 ||
+        static_cast<uint8_t>(this->data[6]) != VERSION)
+        throw std::runtime_error("Unsupported ABO file header: " + this->path);
+    this->flags = static_cast<uint8_t>(this->data[7]);
+
+    // ---- Trailer ----
+    const char* trailer = this->data + this->size - TRAILER_SIZE;
+    if (std::memcmp(trailer + sizeof(uint64_t), "ABOI", 4) != 0)
+        throw std::runtime_error("Corrupt ABO file (missing frame index): " + this->path);
+    this->index_offset = read_le<uint64_t>(trailer);
+
+    // ---- Index ----
+    const size_t index_end = this->size - TRAILER_SIZE;
+    if (this->index_offset < HEADER_SIZE || this->index_offset > index_end - 2 * sizeof(uint32_t))
+        throw std::runtime_error("Corrupt ABO file (invalid frame index): " + this->path);
+
+    const char* index = this->data + this->index_offset;
+    this->nr_chunks = read_le<uint32_t>(index);
+    this->nr_frames = read_le<uint32_t>(index + sizeof(uint32_t));
+    if (index_end - this->index_offset - 2 * sizeof(uint32_t) !=
+        static_cast<uint64_t>(this->nr_chunks) * CHUNK_ENTRY_SIZE + static_cast<uint64_t>(this->nr_frames) * FRAME_ENTRY_SIZE)
+        throw std::runtime_error("Corrupt ABO file (invalid frame index): " + this->path);
+
+    this->chunk_table = index + 2 * sizeof(uint32_t);
+    this->frame_table = this->chunk_table + static_cast<size_t>(this->nr_chunks) * CHUNK_ENTRY_SIZE;
+}
+
+/**
+ * @brief Get the index entry of a chunk
+ * @param chunk_id chunk index
+ * @return index entry
+ */
+AbofReader::ChunkInfo AbofReader::get_chunk_info(size_t chunk_id) const {
+    if (chunk_id >= this->nr_chunks)
+        throw std::runtime_error("Invalid chunk id: " + std::to_string(chunk_id) + "/" + std::to_string(this->nr_chunks));
+
+    const char* entry = this->chunk_table + chunk_id * CHUNK_ENTRY_SIZE;
+    ChunkInfo info;
+    info.offset = read_le<uint64_t>(entry);
+    info.stored_size = read_le<uint64_t>(entry + 8);
+    info.size = read_le<uint64_t>(entry + 16);
+    info.first_frame = read_le<uint32_t>(entry + 24);
+    info.nr_frames = read_le<uint32_t>(entry + 28);
+
+    // chunks reside between the header and the index
+    if (info.offset < HEADER_SIZE || info.offset > this->index_offset ||
+        info.stored_size > this->index_offset - info.offset ||
+        info.first_frame > this->nr_frames || info.nr_frames > this->nr_frames - info.first_frame ||
+        (!this->is_compressed() && info.size != info.stored_size))
+        throw std::runtime_error("Corrupt ABO file (invalid chunk entry): " + this->path);
+
+    return info;
+}
+
+/**
+ * @brief Get the index entry of a frame
+ * @param frame_id frame index
+ * @return index entry
+ */
+AbofReader::FrameInfo AbofReader::get_frame_info(size_t frame_id) const {
+    if (frame_id >= this->nr_frames)
+        throw std::runtime_error("Invalid frame id: " + std::to_string(frame_id) + "/" + std::to_string(this->nr_frames));
+
+    const char* entry = this->frame_table + frame_id * FRAME_ENTRY_SIZE;
+    FrameInfo info;
+    info.chunk = read_le<uint32_t>(entry);
+    info.offset = read_le<uint32_t>(entry + 4);
+    info.nr_atoms = read_le<uint32_t>(entry + 8);
+    info.nr_models = read_le<uint32_t>(entry + 12);
+    std::memcpy(info.bounds.data(), entry + 16, info.bounds.size() * sizeof(float));
+
+    if (info.chunk >= this->nr_chunks)
+        throw std::runtime_error("Corrupt ABO file (invalid frame entry): " + this->path);
+
+    return info;
+}
+
+/**
+ * @brief Get a cursor over the frame records of a chunk
+ *
+ * Compressed chunks are decompressed into the buffer, uncompressed chunks
+ * are read directly from the file.
+ *
+ * @param chunk_id chunk index
+ * @param buffer storage for the decompressed chunk; has to outlive the cursor
+ * @return cursor positioned at the first frame record
+ */
+ByteCursor AbofReader::open_chunk(size_t chunk_id, std::vector<char>& buffer) const {
+    const ChunkInfo info = this->get_chunk_info(chunk_id);
+    const char* stored = this->data + info.offset;
+
+    if (!this->is_compressed())
+        return ByteCursor(stored, static_cast<size_t>(info.stored_size), this->path);
+
+    // the index is not trusted for the allocation; the size has to agree
+    // with the one recorded in the zstd frame itself
+    const unsigned long long content_size = ZSTD_getFrameContentSize(stored, static_cast<size_t>(info.stored_size));
+    if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        content_size != info.size || info.size > MAX_CHUNK_SIZE)
+        throw std::runtime_error("Corrupt ABO file (chunk size mismatch): " + this->path);
+
+    buffer.resize(static_cast<size_t>(info.size));
+    size_t result = ZSTD_decompress(buffer.data(), buffer.size(), stored, static_cast<size_t>(info.stored_size));
+    if (ZSTD_isError(result))
+        throw std::runtime_error(
+            std::string("Failed to decompress ABO chunk: ") +
+            ZSTD_getErrorName(result));
+    if (result != buffer.size())
+        throw std::runtime_error("Corrupt ABO file (chunk size mismatch): " + this->path);
+
+    return ByteCursor(buffer.data(), buffer.size(), this->path);
+}
+
+/**
+ * @brief Get a cursor positioned at a single frame record
+ * @param frame_id frame index
+ * @param buffer storage for the decompressed chunk; has to outlive the cursor
+ * @return cursor positioned at the frame record
+ */
+ByteCursor AbofReader::open_frame(size_t frame_id, std::vector<char>& buffer) const {
+    const FrameInfo info = this->get_frame_info(frame_id);
+    ByteCursor cursor = this->open_chunk(info.chunk, buffer);
+    cursor.seek(info.offset);
+    return cursor;
+}
@@ -0,0 +1,158 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef ABOF_READER_H
+#define ABOF_READER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+
+#include "byte_cursor.h"
+
+/**
+ * @brief Random access to the chunks and frames of a seekable (version 3)
+ *        ABOF file
+ *
+ * The frames are grouped into chunks that are compressed independently. A
+ * trailing index records the position of every chunk and the position and
+ * metadata of every frame, such that any frame is reached by decoding a single
+ * chunk. The file stays memory-mapped for the lifetime of the reader and the
+ * index entries are read on demand, hence opening a file takes constant time
+ * regardless of its number of frames.
+ */
+class AbofReader
+{
+public:
+    /**
+     * @brief Index entry of a chunk
+     */
+    struct ChunkInfo {
+        uint64_t offset;            // position of the chunk in the file
+        uint64_t stored_size;       // number of bytes in the file
+        uint64_t size;              // number of bytes after decompression
+        uint32_t first_frame;       // index of the first frame in the chunk
+        uint32_t nr_frames;         // number of frames in the chunk
+    };
+
+    /**
+     * @brief Index entry of a frame
+     */
+    struct FrameInfo {
+        uint32_t chunk;                 // chunk holding the frame record
+        uint32_t offset;                // position of the frame record in the decompressed chunk
+        uint32_t nr_atoms;
+        uint32_t nr_models;
+        std::array<float, 6> bounds;    // smallest and largest coordinates of atoms and vertices
+    };
+
+    static constexpr uint8_t VERSION = 3;
+    static constexpr size_t HEADER_SIZE = 8;
+    static constexpr size_t TRAILER_SIZE = 12;
+    static constexpr size_t CHUNK_ENTRY_SIZE = 32;
+    static constexpr size_t FRAME_ENTRY_SIZE = 40;
+    static constexpr uint64_t MAX_CHUNK_SIZE = 1ull << 30;    // largest decompressed chunk accepted
+
+private:
+    std::string path;
+    QFile file;
+    QByteArray contents;            // file contents when the file cannot be mapped
+    const char* data = nullptr;
+    size_t size = 0;
+
+    uint8_t flags = 0;
+    uint64_t index_offset = 0;
+    uint32_t nr_chunks = 0;
+    uint32_t nr_frames = 0;
+    const char* chunk_table = nullptr;
+    const char* frame_table = nullptr;
+
+public:
+    /**
+     * @brief AbofReader constructor, opens a file and reads its header and
+     *        index
+     * @param path path to file
+     */
+    AbofReader(const std::string& _path);
+
+    AbofReader(const AbofReader&) = delete;
+    AbofReader& operator=(const AbofReader&) = delete;
+
+    inline size_t get_nr_chunks() const {
+        return this->nr_chunks;
+    }
+
+    inline size_t get_nr_frames() const {
+        return this->nr_frames;
+    }
+
+    inline bool is_compressed() const {
+        return (this->flags & 0x01) != 0;
+    }
+
+    inline bool is_neb_pathway() const {
+        return (this->flags & 0x02) != 0;
+    }
+
+    inline const std::string& get_path() const {
+        return this->path;
+    }
+
+    /**
+     * @brief Get the index entry of a chunk
+     * @param chunk_id chunk index
+     * @return index entry
+     */
+    ChunkInfo get_chunk_info(size_t chunk_id) const;
+
+    /**
+     * @brief Get the index entry of a frame
+     * @param frame_id frame index
+     * @return index entry
+     */
+    FrameInfo get_frame_info(size_t frame_id) const;
+
+    /**
+     * @brief Get a cursor over the frame records of a chunk
+     *
+     * Compressed chunks are decompressed into the buffer, uncompressed chunks
+     * are read directly from the file.
+     *
+     * @param chunk_id chunk index
+     * @param buffer storage for the decompressed chunk; has to outlive the cursor
+     * @return cursor positioned at the first frame record
+     */
+    ByteCursor open_chunk(size_t chunk_id, std::vector<char>& buffer) const;
+
+    /**
+     * @brief Get a cursor positioned at a single frame record
+     * @param frame_id frame index
+     * @param buffer storage for the decompressed chunk; has to outlive the cursor
+     * @return cursor positioned at the frame record
+     */
+    ByteCursor open_frame(size_t frame_id, std::vector<char>& buffer) const;
+};
+
+#endif // ABOF_READER_H
@@ -26,46 +26,7 @@
  */
 AtomSettings::AtomSettings() {
     this->load();
-
-    // set all bonds by default to 3.0
-    this->bond_distances.resize(121);
-    for(unsigned int i=0; i<121; i++) {
-        this->bond_distances[i].resize(121, 3.0);
-    }
-
-    // loop over all atoms
-    for(unsigned int i=0; i<121; i++) {
-        if(i > 20) {
-            for(unsigned int j=2; j<=20; j++) {
-                // bonds for hydrogen
-                this->bond_distances[i][1] = 2.0;
-                this->bond_distances[1][i] = 2.0;
-
-                // other atoms
-                this->bond_distances[i][j] = 2.5;
-                this->bond_distances[j][i] = 2.5;
-            }
-        } else {
-            for(unsigned int j=2; j<=20; j++) {
-                // bonds for hydrogen
-                this->bond_distances[i][1] = 1.2;
-                this->bond_distances[1][i] = 1.2;
-
-                // other atoms
-                this->bond_distances[i][j] = 2.0;
-                this->bond_distances[j][i] = 2.0;
-            }
-        }
-    }
-
-    // add some special cases on the basis of user input
-    this->bond_distances[6][13] = 3.5; // Al-C
-    this->bond_distances[13][6] = 3.5;
-
-    this->radii.resize(119);
-    for(unsigned int i=1; i<=118; i++) {
-        this->radii[i] = this->get_atom_radius(this->get_name_from_elnr(i));
-    }
+    this->build_tables();
 }
 
 /**
@@ -94,16 +55,58 @@ void AtomSettings::load() {
 }
 
 /**
- * @brief      Get the default color for an atom
- *
- * @param[in]  elname  Element name
- *
- * @return     Color of the atom
+ * @brief      Build the element-indexed property tables
  */
-glm::vec3 AtomSettings::get_atom_color(const std::string& elname){
-    QString hexColor = this->root["atoms"]["colors"][QString(elname.c_str())].toString();
-    QColor *getColor = new QColor(hexColor);
-    return glm::vec3((float)getColor->red()/255, (float)getColor->green()/255, (float)getColor->blue()/255);
+void AtomSettings::build_tables() {
+    this->names.assign(NR_ELEMENTS, std::string());
+    this->colors.assign(NR_ELEMENTS, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+    this->radii.assign(NR_ELEMENTS, 0.0f);
+    this->elnrs.clear();
+
+    const auto atoms = this->root["atoms"];
+    for(unsigned int i=0; i<NR_ELEMENTS; i++) {
+        const QString name = atoms["nr2element"][QString::number(i)].toString();
+        if(name.isEmpty()) {
+            continue;
+        }
+
+        this->names[i] = name.toStdString();
+        this->elnrs.emplace(this->names[i], i);
+
+        const QColor color(atoms["colors"][name].toString());
+        this->colors[i] = glm::vec4((float)color.red()/255, (float)color.green()/255, (float)color.blue()/255, 1.0f);
+
+        this->radii[i] = atoms["radii"][name].toString().toDouble();
+    }
+
+    // set all bonds by default to 3.0
+    this->bond_distances.assign(NR_ELEMENTS * NR_ELEMENTS, 3.0);
+
+    // loop over all atoms
+    for(unsigned int i=0; i<NR_ELEMENTS; i++) {
+        if(i > 20) {
+            for(unsigned int j=2; j<=20; j++) {
+                // bonds for hydrogen
+                this->set_bond_distance(i, 1, 2.0);
+
+                // other atoms
+                this->set_bond_distance(i, j, 2.5);
+            }
+        } else {
+            for(unsigned int j=2; j<=20; j++) {
+                // bonds for hydrogen
+                this->set_bond_distance(i, 1, 1.2);
+
+                // other atoms
+                this->set_bond_distance(i, j, 2.0);
+            }
+        }
+    }
+
+    // add some special cases on the basis of user input
+    this->set_bond_distance(6, 13, 3.5); // Al-C
+
+    this->max_bond_distance = *std::max_element(this->bond_distances.begin(), this->bond_distances.end());
 }
 
 /**
@@ -113,21 +116,20 @@ glm::vec3 AtomSettings::get_atom_color(const std::string& elname){
  *
  * @return     Color of the atom
  */
-QVector3D AtomSettings::get_atom_color_qvector(const std::string& elname){
-    QString hexColor = this->root["atoms"]["colors"][QString(elname.c_str())].toString();
-    QColor *getColor = new QColor(hexColor);
-    return QVector3D((float)getColor->red()/255, (float)getColor->green()/255, (float)getColor->blue()/255);
+glm::vec3 AtomSettings::get_atom_color(const std::string& elname) const {
+    return glm::vec3(this->get_atom_color_from_elnr(this->get_atom_elnr(elname)));
 }
 
 /**
- * @brief      Get the atomic radius of an element
+ * @brief      Get the default color for an atom
  *
  * @param[in]  elname  Element name
  *
- * @return     atomic radius
+ * @return     Color of the atom
  */
-float AtomSettings::get_atom_radius(const std::string& elname){
-    return this->root["atoms"]["radii"][QString(elname.c_str())].toString().toDouble();
+QVector3D AtomSettings::get_atom_color_qvector(const std::string& elname) const {
+    const glm::vec4& color = this->get_atom_color_from_elnr(this->get_atom_elnr(elname));
+    return QVector3D(color.r, color.g, color.b);
 }
 
 /**
@@ -137,8 +139,8 @@ float AtomSettings::get_atom_radius(const std::string& elname){
  *
  * @return     atomic radius
  */
-float AtomSettings::get_atom_radius_from_elnr(unsigned int elnr) {
-    return this->radii[elnr];
+float AtomSettings::get_atom_radius(const std::string& elname) const {
+    return this->get_atom_radius_from_elnr(this->get_atom_elnr(elname));
 }
 
 /**
@@ -148,29 +150,7 @@ float AtomSettings::get_atom_radius_from_elnr(unsigned int elnr) {
  *
  * @return     The atom elnr.
  */
-unsigned int AtomSettings::get_atom_elnr(const std::string& elname){
-    return this->root["atoms"]["elnr"][QString(elname.c_str())].toString().toUInt();
-}
-
-/**
- * @brief      Get the maximum bond distance between two atoms
- *
- * @param[in]  atoma  The atoma
- * @param[in]  atomb  The atomb
- *
- * @return     The bond distance.
- */
-double AtomSettings::get_bond_distance(int atoma, int atomb) {
-    return this->bond_distances[atoma][atomb];
-}
-
-/**
- * @brief      Gets the name from element number.
- *
- * @param[in]  elnr  The elnr
- *
- * @return     The name from elnr.
- */
-std::string AtomSettings::get_name_from_elnr(unsigned int elnr) {
-    return this->root["atoms"]["nr2element"][QString::number(elnr)].toString().toStdString();
+unsigned int AtomSettings::get_atom_elnr(const std::string& elname) const {
+    auto got = this->elnrs.find(elname);
+    return got != this->elnrs.end() ? got->second : 0;
 }
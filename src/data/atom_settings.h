@@ -39,18 +39,31 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <algorithm>
 
 /**
  * @brief      Class holding information about atoms in the periodic table
+ *
+ * All per-element properties are parsed once from atoms.json into flat,
+ * element-indexed tables such that the render and bond construction routines
+ * only perform array lookups.
  */
 class AtomSettings {
+public:
+    // number of entries in the element tables (element numbers 0 - 120)
+    static constexpr unsigned int NR_ELEMENTS = 121;
+
 private:
     std::string settings_file;
     QJsonDocument root;
     QFile qf;
 
-    std::vector<std::vector<double>> bond_distances;
-    std::vector<float> radii;
+    std::vector<std::string> names;                             // element number -> name
+    std::unordered_map<std::string, unsigned int> elnrs;        // name -> element number
+    std::vector<glm::vec4> colors;                              // element number -> RGBA color
+    std::vector<float> radii;                                   // element number -> radius
+    std::vector<double> bond_distances;                         // NR_ELEMENTS x NR_ELEMENTS cutoffs
+    double max_bond_distance = 0.0;
 
 public:
 
@@ -73,7 +86,7 @@ public:
      *
      * @return     Color of the atom
      */
-    glm::vec3 get_atom_color(const std::string& elname);
+    glm::vec3 get_atom_color(const std::string& elname) const;
 
     /**
      * @brief      Get the default color for an atom
@@ -82,7 +95,18 @@ public:
      *
      * @return     Color of the atom
      */
-    QVector3D get_atom_color_qvector(const std::string& elname);
+    QVector3D get_atom_color_qvector(const std::string& elname) const;
+
+    /**
+     * @brief      Get the default color of an element
+     *
+     * @param[in]  elnr  The element number
+     *
+     * @return     RGBA color of the atom
+     */
+    inline const glm::vec4& get_atom_color_from_elnr(unsigned int elnr) const {
+        return this->colors[elnr < NR_ELEMENTS ? elnr : 0];
+    }
 
     /**
      * @brief      Get the atomic radius of an element
@@ -91,16 +115,18 @@ public:
      *
      * @return     atomic radius
      */
-    float get_atom_radius(const std::string& elname);
+    float get_atom_radius(const std::string& elname) const;
 
     /**
      * @brief      Get the atomic radius of an element
      *
-     * @param[in]  elname  Element name
+     * @param[in]  elnr  The element number
      *
      * @return     atomic radius
      */
-    float get_atom_radius_from_elnr(unsigned int elnr);
+    inline float get_atom_radius_from_elnr(unsigned int elnr) const {
+        return this->radii[elnr < NR_ELEMENTS ? elnr : 0];
+    }
 
     /**
      * @brief      Get element number of an element
@@ -109,7 +135,7 @@ public:
      *
      * @return     The atom elnr.
      */
-    unsigned int get_atom_elnr(const std::string& elname);
+    unsigned int get_atom_elnr(const std::string& elname) const;
 
     /**
      * @brief      Get the maximum bond distance between two atoms
@@ -119,7 +145,19 @@ public:
      *
      * @return     The bond distance.
      */
-    double get_bond_distance(int atoma, int atomb);
+    inline double get_bond_distance(unsigned int atoma, unsigned int atomb) const {
+        return this->bond_distances[(atoma < NR_ELEMENTS ? atoma : 0) * NR_ELEMENTS +
+                                    (atomb < NR_ELEMENTS ? atomb : 0)];
+    }
+
+    /**
+     * @brief      Get the largest bond distance over all element pairs
+     *
+     * @return     The maximum bond distance.
+     */
+    inline double get_max_bond_distance() const {
+        return this->max_bond_distance;
+    }
 
     /**
      * @brief      Gets the name from element number.
@@ -128,7 +166,9 @@ public:
      *
      * @return     The name from elnr.
      */
-    std::string get_name_from_elnr(unsigned int elnr);
+    inline const std::string& get_name_from_elnr(unsigned int elnr) const {
+        return this->names[elnr < NR_ELEMENTS ? elnr : 0];
+    }
 
 private:
     /**
@@ -141,6 +181,23 @@ private:
      */
     void load();
 
+    /**
+     * @brief      Build the element-indexed property tables
+     */
+    void build_tables();
+
+    /**
+     * @brief      Set the bond distance for a pair of elements
+     *
+     * @param[in]  atoma     The atoma
+     * @param[in]  atomb     The atomb
+     * @param[in]  distance  The bond distance
+     */
+    inline void set_bond_distance(unsigned int atoma, unsigned int atomb, double distance) {
+        this->bond_distances[atoma * NR_ELEMENTS + atomb] = distance;
+        this->bond_distances[atomb * NR_ELEMENTS + atoma] = distance;
+    }
+
     // delete copy constructor
     AtomSettings(AtomSettings const&)          = delete;
     void operator=(AtomSettings const&)    = delete;
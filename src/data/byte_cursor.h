@@ -0,0 +1,128 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef BYTE_CURSOR_H
+#define BYTE_CURSOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Bounds-checked sequential reader over a contiguous block of bytes
+ *
+ * The cursor does not own the bytes; these have to outlive the cursor. Values
+ * are read in the byte order of the host, which is little endian on all
+ * supported platforms.
+ */
+class ByteCursor
+{
+private:
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+    std::string source;     // name of the source of the bytes, used in error messages
+
+public:
+    /**
+     * @brief ByteCursor constructor
+     * @param data first byte
+     * @param size number of bytes
+     * @param source name of the source of the bytes
+     */
+    ByteCursor(const char* _data, size_t _size, const std::string& _source) :
+        data(_data),
+        size(_size),
+        source(_source) {}
+
+    /**
+     * @brief Read a single value and advance the cursor
+     * @return value
+     */
+    template<typename T>
+    inline T read() {
+        T value;
+        std::memcpy(&value, this->view(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Copy a number of bytes and advance the cursor
+     * @param dest destination
+     * @param nbytes number of bytes
+     */
+    inline void read(void* dest, size_t nbytes) {
+        if(nbytes == 0) {
+            return;
+        }
+        std::memcpy(dest, this->view(nbytes), nbytes);
+    }
+
+    /**
+     * @brief Get direct access to a number of bytes and advance the cursor
+     * @param nbytes number of bytes
+     * @return pointer to the first byte
+     */
+    inline const char* view(size_t nbytes) {
+        if(nbytes > this->size - this->pos) {
+            throw std::runtime_error("Corrupt ABO file (unexpected EOF): " + this->source);
+        }
+        const char* ptr = this->data + this->pos;
+        this->pos += nbytes;
+        return ptr;
+    }
+
+    /**
+     * @brief Get direct access to an array of fixed-size records and advance
+     *        the cursor
+     * @param count number of records
+     * @param record_size number of bytes per record
+     * @return pointer to the first byte
+     */
+    inline const char* view(size_t count, size_t record_size) {
+        if(record_size != 0 && count > this->remaining() / record_size) {
+            throw std::runtime_error("Corrupt ABO file (unexpected EOF): " + this->source);
+        }
+        return this->view(count * record_size);
+    }
+
+    /**
+     * @brief Move the cursor to a position
+     * @param offset number of bytes from the first byte
+     */
+    inline void seek(size_t offset) {
+        if(offset > this->size) {
+            throw std::runtime_error("Corrupt ABO file (unexpected EOF): " + this->source);
+        }
+        this->pos = offset;
+    }
+
+    /**
+     * @brief Get the number of bytes that have not been read yet
+     * @return number of bytes
+     */
+    inline size_t remaining() const {
+        return this->size - this->pos;
+    }
+};
+
+#endif // BYTE_CURSOR_H
@@ -21,23 +21,169 @@
 
 #include "container.h"
 
-Container::Container() {}
+Container::Container() :
+    max_memory_size(0) {}
+
+/**
+ * @brief Constructs a container whose frames are decoded on first access
+ * @param _provider source of the frames
+ * @param _max_memory_size maximum number of bytes held by materialized frames
+ */
+Container::Container(const std::shared_ptr<FrameProvider>& _provider,
+                     size_t _max_memory_size) :
+    provider(_provider),
+    max_memory_size(_max_memory_size) {}
+
+/**
+ * @brief Add a frame to a container that holds all frames in memory
+ * @param frame the frame
+ */
+void Container::add_frame(const std::shared_ptr<Frame> frame) {
+    this->add_to_trajectory(*frame);
+    this->frames.push_back(frame);
+}
+
+/**
+ * @brief Store the frames as a trajectory; applies to the frames that are
+ *        added or materialized afterwards
+ *
+ * The element identities and the bonds of a frame are shared with the
+ * previous frame where these are identical, such that every frame only
+ * holds the positions of its atoms. A change of the bonds, e.g. in a
+ * reactive trajectory, hence only affects the frames following the change.
+ *
+ * @param precision storage precision of the atomic positions
+ */
+void Container::set_trajectory_mode(Structure::Precision precision) {
+    this->flag_trajectory = true;
+    this->position_precision = precision;
+}
+
+/**
+ * @brief Get a frame, decoding it when it is not held in memory
+ * @param frame_id frame index
+ * @return frame
+ */
+std::shared_ptr<Frame> Container::frame(unsigned int frame_id) {
+    if(frame_id >= this->get_nr_frames()) {
+        throw std::runtime_error("Invalid frame id: " + std::to_string(frame_id)
+                                 + "/" + std::to_string(this->get_nr_frames()));
+    }
+
+    if(!this->provider) {
+        return this->frames[frame_id];
+    }
+
+    auto it = this->lookup.find(frame_id);
+    if(it != this->lookup.end()) {
+        this->cached_frames.splice(this->cached_frames.begin(), this->cached_frames, it->second);
+        return it->second->frame;
+    }
+
+    auto frame = this->provider->load_frame(frame_id);
+    this->add_to_trajectory(*frame);
+
+    // charge the frame once, such that data shared with the previous frame
+    // is not counted twice; the same amount is returned upon eviction
+    const size_t nbytes = frame->get_memory_size();
+    this->cached_frames.push_front({frame_id, frame, nbytes});
+    this->lookup[frame_id] = this->cached_frames.begin();
+    this->memory_size += nbytes;
+    this->evict();
+
+    return frame;
+}
+
+/**
+ * @brief Set the maximum number of bytes held by materialized frames,
+ *        evicting the least recently used frames when exceeded
+ * @param _max_memory_size maximum number of bytes
+ */
+void Container::set_max_memory_size(size_t _max_memory_size) {
+    this->max_memory_size = _max_memory_size;
+    this->evict();
+}
 
 /**
  * @brief Get maximum dimension of all objects
+ *
+ * The frames of a frame provider are not decoded; instead, the corners of
+ * their bounding boxes are used, centered by the unit cell of the first frame.
+ * Frames whose bounding box is not known yet are not taken into account.
+ *
  * @return Maximal dimension
  */
-float Container::get_max_dim() const {
+float Container::get_max_dim() {
     float maxval = 0.0;
+
+    if(this->provider) {
+        if(this->get_nr_frames() == 0) {
+            return maxval;
+        }
+
+        const QVector3D center = this->frame(0)->get_structure()->get_center_vector();
+        for(size_t i=0; i<this->get_nr_frames(); i++) {
+            const auto bounds = this->provider->get_bounds(i);
+            if(!bounds) {
+                continue;
+            }
+
+            for(unsigned int corner=0; corner<8; corner++) {
+                const QVector3D p((*bounds)[(corner & 1) ? 3 : 0],
+                                  (*bounds)[(corner & 2) ? 4 : 1],
+                                  (*bounds)[(corner & 4) ? 5 : 2]);
+                maxval = std::max(maxval, (p + center).length());
+            }
+        }
+
+        return maxval;
+    }
+
     for(const auto& frame : this->frames) {
-        for(const auto& atom : frame->get_structure()->get_atoms()) {
-            maxval = std::max(maxval, (float)atom.get_pos_qtvec().length());
+        // periodic structures are rendered with the center of the unit cell
+        // at the origin
+        const QVector3D center = frame->get_structure()->get_center_vector();
+
+        const auto& structure = frame->get_structure();
+        for(unsigned int i=0; i<structure->get_nr_atoms(); i++) {
+            maxval = std::max(maxval, (structure->get_position(i) + center).length());
         }
 
         for(const auto& model : frame->get_models()) {
-            maxval = std::max(maxval, glm::length(model->get_max_dim()));
+            maxval = std::max(maxval, glm::length(model->get_max_dim(glm::vec3(center[0], center[1], center[2]))));
         }
     }
 
     return maxval;
 }
+
+/**
+ * @brief Let the structure of a frame share the topology of the previous
+ *        frame and store its positions at the trajectory precision
+ * @param frame the frame
+ */
+void Container::add_to_trajectory(Frame& frame) {
+    if(!this->flag_trajectory) {
+        return;
+    }
+
+    const auto& structure = frame.get_structure();
+    structure->set_precision(this->position_precision);
+    if(this->reference_structure) {
+        structure->share_topology(*this->reference_structure);
+    }
+    this->reference_structure = structure;
+}
+
+/**
+ * @brief Evict the least recently used frames until the materialized
+ *        frames fit in the memory budget; the most recent frame is kept
+ */
+void Container::evict() {
+    while(this->memory_size > this->max_memory_size && this->cached_frames.size() > 1) {
+        const auto& entry = this->cached_frames.back();
+        this->memory_size -= entry.nbytes;
+        this->lookup.erase(entry.frame_id);
+        this->cached_frames.pop_back();
+    }
+}
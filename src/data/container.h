@@ -23,36 +23,111 @@
 #define CONTAINER_H
 
 #include <vector>
+#include <list>
 #include <memory>
 #include <exception>
+#include <unordered_map>
 
 #include "frame.h"
+#include "frame_provider.h"
 
+/**
+ * @brief Sequence of frames
+ *
+ * The frames are either added up front or materialized on first access from
+ * a frame provider. Materialized frames are kept in least-recently-used order
+ * up to a maximum number of bytes, such that trajectories larger than the
+ * available memory can be played back. In trajectory mode, consecutive frames
+ * share their element identities and bonds where these are identical, such
+ * that every frame only holds the positions of its atoms. A container is only
+ * to be used from the gui thread; its frame provider can be handed to a
+ * worker thread to prefetch frames.
+ */
 class Container
 {
 private:
+    struct Entry {
+        size_t frame_id;
+        std::shared_ptr<Frame> frame;
+        size_t nbytes;                                              // bytes charged when the frame was materialized
+    };
+
     std::vector<std::shared_ptr<Frame>> frames;
     bool flag_is_neb_pathway = false;
 
+    std::shared_ptr<FrameProvider> provider;                        // source of the frames, if any
+    std::list<Entry> cached_frames;                                 // most recently used first
+    std::unordered_map<size_t, std::list<Entry>::iterator> lookup;  // position of the frames in the list
+    size_t memory_size = 0;                                         // bytes held by the materialized frames
+    size_t max_memory_size;                                         // maximum bytes held by the materialized frames
+
+    bool flag_trajectory = false;                                   // whether frames share their topology
+    Structure::Precision position_precision = Structure::Precision::FLOAT;
+    std::shared_ptr<const Structure> reference_structure;           // structure of the previous frame
+
 public:
     Container();
 
-    inline void add_frame(const std::shared_ptr<Frame> frame) {
-        this->frames.push_back(frame);
-    }
+    /**
+     * @brief Constructs a container whose frames are decoded on first access
+     * @param _provider source of the frames
+     * @param _max_memory_size maximum number of bytes held by materialized frames
+     */
+    Container(const std::shared_ptr<FrameProvider>& _provider,
+              size_t _max_memory_size = 256 * 1024 * 1024);
+
+    /**
+     * @brief Add a frame to a container that holds all frames in memory
+     * @param frame the frame
+     */
+    void add_frame(const std::shared_ptr<Frame> frame);
 
-    inline std::shared_ptr<Frame> frame(unsigned int frame_id) {
-        if(frame_id >= frames.size()) {
-            throw std::runtime_error("Invalid frame id: " + std::to_string(frame_id)
-                                     + "/" + std::to_string(frames.size()));
-        }
-        return this->frames[frame_id];
+    /**
+     * @brief Store the frames as a trajectory; applies to the frames that are
+     *        added or materialized afterwards
+     * @param precision storage precision of the atomic positions
+     */
+    void set_trajectory_mode(Structure::Precision precision = Structure::Precision::FLOAT);
+
+    inline bool is_trajectory() const {
+        return this->flag_trajectory;
     }
 
+    /**
+     * @brief Get a frame, decoding it when it is not held in memory
+     * @param frame_id frame index
+     * @return frame
+     */
+    std::shared_ptr<Frame> frame(unsigned int frame_id);
+
     inline size_t get_nr_frames() const {
-        return this->frames.size();
+        return this->provider ? this->provider->get_nr_frames() : this->frames.size();
     }
 
+    /**
+     * @brief Whether a frame is available without decoding it
+     * @param frame_id frame index
+     * @return whether the frame is held in memory
+     */
+    inline bool is_materialized(size_t frame_id) const {
+        return !this->provider || this->lookup.find(frame_id) != this->lookup.end();
+    }
+
+    /**
+     * @brief Get the source of the frames
+     * @return frame provider; null when all frames are held in memory
+     */
+    inline const std::shared_ptr<FrameProvider>& get_frame_provider() const {
+        return this->provider;
+    }
+
+    /**
+     * @brief Set the maximum number of bytes held by materialized frames,
+     *        evicting the least recently used frames when exceeded
+     * @param _max_memory_size maximum number of bytes
+     */
+    void set_max_memory_size(size_t _max_memory_size);
+
     inline void set_is_neb_pathway(bool is_neb_pathway) {
         this->flag_is_neb_pathway = is_neb_pathway;
     }
@@ -65,7 +140,21 @@ public:
      * @brief Get maximum dimension of all objects
      * @return Maximal dimension
      */
-    float get_max_dim() const;
+    float get_max_dim();
+
+private:
+    /**
+     * @brief Let the structure of a frame share the topology of the previous
+     *        frame and store its positions at the trajectory precision
+     * @param frame the frame
+     */
+    void add_to_trajectory(Frame& frame);
+
+    /**
+     * @brief Evict the least recently used frames until the materialized
+     *        frames fit in the memory budget; the most recent frame is kept
+     */
+    void evict();
 };
 
 #endif // CONTAINER_H
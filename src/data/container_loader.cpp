@@ -20,14 +20,21 @@
  **************************************************************************/
 
 #include "container_loader.h"
+#include "abof_frame_provider.h"
+#include "stream_frame_provider.h"
+#include "octahedral_normal.h"
 
 #include <array>
 #include <cmath>
+#include <cstring>
+#include <exception>
 #include <limits>
 #include <optional>
 #include <sstream>
 #include <vector>
-#include <zstd.h>
+
+#include <QByteArray>
+#include <QFile>
 
 /**
  * @brief ContainerLoader constructor
@@ -54,264 +61,145 @@ glm::vec3 catmull_rom(const glm::vec3& p0,
                    (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
 }
 
-
 } // namespace
 
 /**
  * @brief      Loads an abo file from hard drive stored as little endian binary
  *
+ * The file is memory-mapped. Uncompressed files are parsed directly from the
+ * mapping. Compressed files are decompressed on a worker thread while the
+ * frames are parsed from the part that has been decompressed so far; apart
+ * from reaction pathways, the frames are parsed on a background thread such
+ * that the container is returned before the whole file has been parsed. The
+ * frames of seekable files are only decoded when they are first accessed.
+ *
  * @param[in]  path   Path to file
  */
 std::shared_ptr<Container> ContainerLoader::load_data_abo(const std::string& path) {
     qDebug() << "Start reading abo file:" << path.c_str();
 
     auto container = std::make_shared<Container>();
-    std::ifstream file(path, std::ios::binary);
+    auto file = std::make_unique<QFile>(QString::fromStdString(path));
 
-    if (!file)
+    if (!file->open(QIODevice::ReadOnly))
         throw std::runtime_error("Could not open file: " + path);
 
-    auto read_or_throw = [&](std::istream& stream, char* data, std::size_t size) {
-        if (size == 0) return;
-        stream.read(data, size);
-        if (!stream)
-            throw std::runtime_error("Corrupt ABO file (unexpected EOF): " + path);
-    };
-
-    enum class NormalEncoding {
-        Float32,
-        Oct16
-    };
-
-    auto decode_octahedral_normal = [](int16_t nx, int16_t ny) {
-        constexpr float scale = 32767.0f;
-        glm::vec3 n(static_cast<float>(nx) / scale,
-                    static_cast<float>(ny) / scale,
-                    0.0f);
-        n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
-        if (n.z < 0.0f) {
-            const float old_x = n.x;
-            n.x = (1.0f - std::abs(n.y)) * (old_x >= 0.0f ? 1.0f : -1.0f);
-            n.y = (1.0f - std::abs(old_x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
-        }
-        const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
-        if (length > 0.0f) {
-            n /= length;
-        }
-        return n;
-    };
+    // fall back to reading the file when it cannot be mapped
+    const qint64 file_size = file->size();
+    QByteArray file_contents;
+    const char* file_data = reinterpret_cast<const char*>(file_size > 0 ? file->map(0, file_size) : nullptr);
+    if (!file_data) {
+        file_contents = file->readAll();
+        file_data = file_contents.constData();
+    }
+    ByteCursor file_cursor(file_data, static_cast<size_t>(file_size), path);
 
-    uint16_t nr_frames = 0;
-    read_or_throw(file, reinterpret_cast<char*>(&nr_frames), sizeof(nr_frames));
+    uint16_t nr_frames = file_cursor.read<uint16_t>();
 
     NormalEncoding normal_encoding = NormalEncoding::Float32;
-    std::unique_ptr<std::istringstream> payload_stream;
-    std::string payload_data;
+    std::unique_ptr<ZstdStream> payload_stream;
     bool is_neb_pathway = false;
     uint8_t abof_version = 0;
     if (nr_frames == 0) {
-        std::array<char, 4> magic{};
-        read_or_throw(file, magic.data(), magic.size());
-        if (std::string(magic.data(), magic.size()) != "ABOF")
+        const char* magic = file_cursor.view(4);
+        if (std::string(magic, 4) != "ABOF")
             throw std::runtime_error("Unsupported ABO file header: " + path);
 
-        uint8_t version = 0;
-        uint8_t flags = 0;
-        read_or_throw(file, reinterpret_cast<char*>(&version), sizeof(version));
-        read_or_throw(file, reinterpret_cast<char*>(&flags), sizeof(flags));
-        if (version != 1 && version != 2)
+        const uint8_t version = file_cursor.read<uint8_t>();
+        const uint8_t flags = file_cursor.read<uint8_t>();
+        if (version < 1 || version > AbofReader::VERSION)
             throw std::runtime_error("Unsupported ABO format version: " + std::to_string(version));
         abof_version = version;
+        qDebug() << "ABOF header detected. Version:" << version << "flags:" << flags;
+
+        // the frames of seekable files are decoded on first access, except
+        // for reaction pathways, which are interpolated between all frames
+        if (version == AbofReader::VERSION) {
+            file->close();
+            auto reader = std::make_shared<AbofReader>(path);
+            if (!reader->is_neb_pathway()) {
+                qDebug() << "  Number of frames:" << reader->get_nr_frames() << "chunks:" << reader->get_nr_chunks();
+                auto lazy_container = std::make_shared<Container>(std::make_shared<AbofFrameProvider>(reader));
+                lazy_container->set_trajectory_mode();
+                return lazy_container;
+            }
+
+            container->set_is_neb_pathway(true);
+            this->add_frames(*container, this->load_chunked_frames(*reader));
+            return container;
+        }
 
         const bool is_compressed = (flags & 0x01) != 0;
         is_neb_pathway = (flags & 0x02) != 0;
         if (is_compressed) {
-            std::vector<char> compressed((std::istreambuf_iterator<char>(file)),
-                                         std::istreambuf_iterator<char>());
-            if (compressed.empty())
+            const size_t compressed_size = file_cursor.remaining();
+            if (compressed_size == 0)
                 throw std::runtime_error("Corrupt ABO file (missing compressed payload): " + path);
 
-            unsigned long long content_size =
-                ZSTD_getFrameContentSize(compressed.data(), compressed.size());
-            if (content_size == ZSTD_CONTENTSIZE_ERROR)
-                throw std::runtime_error("Corrupt ABO file (invalid zstd payload): " + path);
-
-            std::vector<char> decompressed;
-            if (content_size != ZSTD_CONTENTSIZE_UNKNOWN) {
-                decompressed.resize(static_cast<size_t>(content_size));
-                size_t result = ZSTD_decompress(
-                    decompressed.data(), decompressed.size(),
-                    compressed.data(), compressed.size());
-                if (ZSTD_isError(result))
-                    throw std::runtime_error(
-                        std::string("Failed to decompress ABO payload: ") +
-                        ZSTD_getErrorName(result));
-                decompressed.resize(result);
-            } else {
-                ZSTD_DStream* dstream = ZSTD_createDStream();
-                if (!dstream)
-                    throw std::runtime_error("Failed to allocate zstd decompressor");
-                size_t init_result = ZSTD_initDStream(dstream);
-                if (ZSTD_isError(init_result)) {
-                    ZSTD_freeDStream(dstream);
-                    throw std::runtime_error(
-                        std::string("Failed to init zstd decompressor: ") +
-                        ZSTD_getErrorName(init_result));
-                }
-
-                std::vector<char> out_buffer(ZSTD_DStreamOutSize());
-                ZSTD_inBuffer input{compressed.data(), compressed.size(), 0};
-                while (input.pos < input.size) {
-                    ZSTD_outBuffer output{out_buffer.data(), out_buffer.size(), 0};
-                    size_t const ret = ZSTD_decompressStream(dstream, &output, &input);
-                    if (ZSTD_isError(ret)) {
-                        ZSTD_freeDStream(dstream);
-                        throw std::runtime_error(
-                            std::string("Failed to stream-decompress ABO payload: ") +
-                            ZSTD_getErrorName(ret));
-                    }
-                    decompressed.insert(decompressed.end(),
-                                        out_buffer.data(),
-                                        out_buffer.data() + output.pos);
-                }
-                ZSTD_freeDStream(dstream);
-            }
-
-            payload_data.assign(decompressed.begin(), decompressed.end());
-            payload_stream = std::make_unique<std::istringstream>(payload_data, std::ios::binary);
+            payload_stream = std::make_unique<ZstdStream>(file_cursor.view(compressed_size), compressed_size, path);
         }
 
         normal_encoding = NormalEncoding::Oct16;
-        std::istream& input = payload_stream ? static_cast<std::istream&>(*payload_stream)
-                                             : static_cast<std::istream&>(file);
-        read_or_throw(input, reinterpret_cast<char*>(&nr_frames), sizeof(nr_frames));
-        qDebug() << "ABOF header detected. Version:" << version << "flags:" << flags;
+        nr_frames = payload_stream ? payload_stream->read<uint16_t>() : file_cursor.read<uint16_t>();
     }
 
     qDebug() << "  Number of frames:" << nr_frames;
 
+    // the stream provider takes ownership of the file, which holds the
+    // compressed payload, and parses the frames in the background
+    if (payload_stream && !is_neb_pathway) {
+        auto stream_container = std::make_shared<Container>(std::make_shared<StreamFrameProvider>(std::move(file),
+                                                                                                  file_contents,
+                                                                                                  std::move(payload_stream),
+                                                                                                  nr_frames,
+                                                                                                  abof_version));
+        if (nr_frames > 1)
+            stream_container->set_trajectory_mode();
+        return stream_container;
+    }
+
     std::vector<std::shared_ptr<Frame>> loaded_frames;
     loaded_frames.reserve(nr_frames);
 
-    std::istream& input = payload_stream ? static_cast<std::istream&>(*payload_stream)
-                                         : static_cast<std::istream&>(file);
     for (uint16_t f = 0; f < nr_frames; ++f) {
-        uint16_t frame_idx = 0;
-        read_or_throw(input, reinterpret_cast<char*>(&frame_idx), sizeof(frame_idx));
-        qDebug() << "  Frame idx:" << frame_idx;
-
-        // ---- Description ----
-        uint16_t descriptor_length = 0;
-        read_or_throw(input, reinterpret_cast<char*>(&descriptor_length), sizeof(descriptor_length));
-
-        std::string description;
-        if (descriptor_length > 0) {
-            description.resize(descriptor_length);
-            read_or_throw(input, description.data(), descriptor_length);
-        }
-
-        std::optional<UnitCellMatrix> frame_unit_cell;
-        if (abof_version == 2) {
-            uint8_t frame_flags = 0;
-            read_or_throw(input, reinterpret_cast<char*>(&frame_flags), sizeof(frame_flags));
-            if ((frame_flags & FRAME_UNIT_CELL_FLAG_BIT) != 0) {
-                UnitCellMatrix unit_cell{};
-                read_or_throw(input,
-                              reinterpret_cast<char*>(unit_cell.data()),
-                              unit_cell.size() * sizeof(float));
-                frame_unit_cell = unit_cell;
-            }
-        }
-
-        // ---- Atoms ----
-        uint16_t nr_atoms = 0;
-        read_or_throw(input, reinterpret_cast<char*>(&nr_atoms), sizeof(nr_atoms));
-        qDebug() << "  Number of atoms:" << nr_atoms;
-
-        std::vector<uint8_t> elements(nr_atoms);
-        std::vector<glm::vec3> positions(nr_atoms);
-
-        for (uint16_t j = 0; j < nr_atoms; ++j) {
-            read_or_throw(input, reinterpret_cast<char*>(&elements[j]), sizeof(uint8_t));
-            read_or_throw(input, reinterpret_cast<char*>(&positions[j][0]), 3 * sizeof(float));
-        }
-
-        auto structure = std::make_shared<Structure>();
-        for (uint16_t j = 0; j < nr_atoms; ++j)
-            structure->add_atom(elements[j], positions[j].x, positions[j].y, positions[j].z);
-
-        structure->update();
-
-        auto frame = std::make_shared<Frame>(structure, description);
-        frame->set_unit_cell(frame_unit_cell);
-
-        // ---- Models ----
-        uint16_t nr_models = 0;
-        read_or_throw(input, reinterpret_cast<char*>(&nr_models), sizeof(nr_models));
-        qDebug() << "  Number of models:" << nr_models;
-
-        for (uint16_t m = 0; m < nr_models; ++m) {
-            uint16_t model_idx = 0;
-            read_or_throw(input, reinterpret_cast<char*>(&model_idx), sizeof(model_idx));
-
-            QVector4D color;
-            read_or_throw(input, reinterpret_cast<char*>(&color[0]), 4 * sizeof(float));
-
-            uint32_t nr_vertices = 0;
-            read_or_throw(input, reinterpret_cast<char*>(&nr_vertices), sizeof(nr_vertices));
-
-            std::vector<glm::vec3> v_positions(nr_vertices);
-            std::vector<glm::vec3> normals(nr_vertices);
-
-            for (uint32_t k = 0; k < nr_vertices; ++k) {
-                read_or_throw(input, reinterpret_cast<char*>(&v_positions[k][0]), 3 * sizeof(float));
-                if (normal_encoding == NormalEncoding::Float32) {
-                    read_or_throw(input, reinterpret_cast<char*>(&normals[k][0]), 3 * sizeof(float));
-                } else {
-                    int16_t nx = 0;
-                    int16_t ny = 0;
-                    read_or_throw(input, reinterpret_cast<char*>(&nx), sizeof(nx));
-                    read_or_throw(input, reinterpret_cast<char*>(&ny), sizeof(ny));
-                    normals[k] = decode_octahedral_normal(nx, ny);
-                }
-            }
-
-            uint32_t nr_faces = 0;
-            read_or_throw(input, reinterpret_cast<char*>(&nr_faces), sizeof(nr_faces));
-
-            std::vector<uint32_t> indices(nr_faces * 3);
-            if (!indices.empty())
-                read_or_throw(input, reinterpret_cast<char*>(indices.data()), indices.size() * sizeof(uint32_t));
-
-            qDebug() << "    Model idx:" << model_idx << "faces:" << nr_faces;
-
-            if(nr_vertices == 0 || nr_faces == 0) {
-                qDebug() << "Skipping empty model:" << model_idx;
-            } else {
-                auto model = std::make_shared<Model>(v_positions, normals, indices);
-                model->set_color(color);
-                frame->add_model(model);
-            }
-        }
-
-        loaded_frames.push_back(frame);
+        loaded_frames.push_back(this->build_frame(payload_stream ? this->decode_frame(*payload_stream, abof_version, normal_encoding)
+                                                                 : this->decode_frame(file_cursor, abof_version, normal_encoding)));
     }
 
+    // the frames own copies of all data; release the stream and the mapping
+    payload_stream.reset();
+    file->close();
+
     container->set_is_neb_pathway(is_neb_pathway);
+    this->add_frames(*container, std::move(loaded_frames));
 
-    if (is_neb_pathway && loaded_frames.size() >= 2) {
-        const auto& reference_atoms = loaded_frames.front()->get_structure()->get_atoms();
-        const size_t nr_atoms = reference_atoms.size();
+    return container;
+}
+
+/**
+ * @brief      Add loaded frames to a container, interpolating between the
+ *             frames of a reaction pathway
+ *
+ * Containers with several frames are stored as a trajectory, such that the
+ * frames share their element identities and bonds.
+ *
+ * @param      container      The container
+ * @param[in]  loaded_frames  The frames as stored in the file
+ */
+void ContainerLoader::add_frames(Container& container, std::vector<std::shared_ptr<Frame>> loaded_frames) const {
+    if (container.is_neb_pathway() && loaded_frames.size() >= 2) {
+        const auto& reference = loaded_frames.front()->get_structure();
+        const size_t nr_atoms = reference->get_nr_atoms();
 
         bool can_interpolate = nr_atoms > 0;
         for (size_t frame_idx = 1; frame_idx < loaded_frames.size() && can_interpolate; ++frame_idx) {
-            const auto& atoms = loaded_frames[frame_idx]->get_structure()->get_atoms();
-            if (atoms.size() != nr_atoms) {
+            const auto& structure = loaded_frames[frame_idx]->get_structure();
+            if (structure->get_nr_atoms() != nr_atoms) {
                 can_interpolate = false;
                 break;
             }
             for (size_t atom_idx = 0; atom_idx < nr_atoms; ++atom_idx) {
-                if (atoms[atom_idx].atnr != reference_atoms[atom_idx].atnr) {
+                if (structure->get_element(atom_idx) != reference->get_element(atom_idx)) {
                     can_interpolate = false;
                     break;
                 }
@@ -330,27 +218,48 @@ std::shared_ptr<Container> ContainerLoader::load_data_abo(const std::string& pat
                 const size_t i2 = seg_idx + 1;
                 const size_t i3 = (seg_idx + 2 < loaded_frames.size()) ? seg_idx + 2 : loaded_frames.size() - 1;
 
-                const auto& atoms0 = loaded_frames[i0]->get_structure()->get_atoms();
-                const auto& atoms1 = loaded_frames[i1]->get_structure()->get_atoms();
-                const auto& atoms2 = loaded_frames[i2]->get_structure()->get_atoms();
-                const auto& atoms3 = loaded_frames[i3]->get_structure()->get_atoms();
+                const auto position = [&](size_t frame_idx, size_t atom_idx) {
+                    const QVector3D pos = loaded_frames[frame_idx]->get_structure()->get_position(atom_idx);
+                    return glm::vec3(pos[0], pos[1], pos[2]);
+                };
+
+                // periodic pathways use the unit cell of the frame at the
+                // start of the segment; the positions are interpolated between
+                // the periodic images nearest to that frame, such that atoms
+                // crossing the boundary do not streak across the unit cell
+                const std::optional<UnitCellMatrix>& unit_cell = loaded_frames[i1]->get_unit_cell();
+                glm::mat3 lattice(0.0f);
+                if (unit_cell) {
+                    // the rows of the stored matrix are the lattice vectors
+                    const float* c = unit_cell->data();
+                    lattice = glm::mat3(c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8]);
+                }
+                const bool is_periodic = std::abs(glm::determinant(lattice)) > 1e-6f;
+                const glm::mat3 inverse_lattice = is_periodic ? glm::inverse(lattice) : glm::mat3(0.0f);
+                const auto nearest_image = [&](const glm::vec3& p, const glm::vec3& origin) {
+                    return is_periodic ? p - lattice * glm::round(inverse_lattice * (p - origin)) : p;
+                };
 
                 auto structure = std::make_shared<Structure>();
                 for (size_t atom_idx = 0; atom_idx < nr_atoms; ++atom_idx) {
-                    const glm::vec3 p0(atoms0[atom_idx].x, atoms0[atom_idx].y, atoms0[atom_idx].z);
-                    const glm::vec3 p1(atoms1[atom_idx].x, atoms1[atom_idx].y, atoms1[atom_idx].z);
-                    const glm::vec3 p2(atoms2[atom_idx].x, atoms2[atom_idx].y, atoms2[atom_idx].z);
-                    const glm::vec3 p3(atoms3[atom_idx].x, atoms3[atom_idx].y, atoms3[atom_idx].z);
+                    const glm::vec3 p1 = position(i1, atom_idx);
+                    const glm::vec3 p0 = nearest_image(position(i0, atom_idx), p1);
+                    const glm::vec3 p2 = nearest_image(position(i2, atom_idx), p1);
+                    const glm::vec3 p3 = nearest_image(position(i3, atom_idx), p2);
 
                     const glm::vec3 ipos = catmull_rom(p0, p1, p2, p3, t);
-                    structure->add_atom(atoms1[atom_idx].atnr, ipos.x, ipos.y, ipos.z);
+                    structure->add_atom(reference->get_element(atom_idx), ipos.x, ipos.y, ipos.z);
                 }
+                if (unit_cell)
+                    structure->set_unitcell(QMatrix3x3(unit_cell->data()));
                 structure->update();
 
                 std::ostringstream descriptor;
                 descriptor.precision(std::numeric_limits<float>::max_digits10);
                 descriptor << "NEB interpolated frame " << seg_idx << " t=" << t;
-                return std::make_shared<Frame>(structure, descriptor.str());
+                auto frame = std::make_shared<Frame>(structure, descriptor.str());
+                frame->set_unit_cell(unit_cell);
+                return frame;
             };
 
             for (size_t seg_idx = 0; seg_idx + 1 < loaded_frames.size(); ++seg_idx) {
@@ -367,9 +276,213 @@ std::shared_ptr<Container> ContainerLoader::load_data_abo(const std::string& pat
         }
     }
 
+    if (loaded_frames.size() > 1)
+        container.set_trajectory_mode();
+
     for (const auto& frame : loaded_frames) {
-        container->add_frame(frame);
+        container.add_frame(frame);
     }
+}
 
-    return container;
+/**
+ * @brief      Decode a frame record of a seekable (version 3) ABOF file
+ *
+ * @param      cursor  Cursor positioned at the start of the frame record
+ *
+ * @return     The contents of the frame record
+ */
+ContainerLoader::FrameRecord ContainerLoader::decode_frame_abo(ByteCursor& cursor) const {
+    return this->decode_frame(cursor, AbofReader::VERSION, NormalEncoding::Oct16);
+}
+
+/**
+ * @brief      Decode a frame record of a compressed (version 1 or 2) ABOF file
+ *
+ * @param      stream        Stream positioned at the start of the frame record
+ * @param[in]  abof_version  ABOF version
+ *
+ * @return     The contents of the frame record
+ */
+ContainerLoader::FrameRecord ContainerLoader::decode_frame_stream(ZstdStream& stream, uint8_t abof_version) const {
+    return this->decode_frame(stream, abof_version, NormalEncoding::Oct16);
+}
+
+/**
+ * @brief      Loads all frames of a seekable (version 3) ABOF file,
+ *             decoding the chunks in parallel
+ *
+ * @param[in]  reader  Reader of the file
+ *
+ * @return     The frames
+ */
+std::vector<std::shared_ptr<Frame>> ContainerLoader::load_chunked_frames(const AbofReader& reader) const {
+    qDebug() << "  Number of frames:" << reader.get_nr_frames() << "chunks:" << reader.get_nr_chunks();
+
+    std::vector<FrameRecord> records(reader.get_nr_frames());
+    std::exception_ptr error;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < (int)reader.get_nr_chunks(); ++c) {
+        try {
+            const AbofReader::ChunkInfo info = reader.get_chunk_info(c);
+            std::vector<char> buffer;
+            ByteCursor cursor = reader.open_chunk(c, buffer);
+            for (uint32_t f = info.first_frame; f < info.first_frame + info.nr_frames; ++f) {
+                const AbofReader::FrameInfo frame_info = reader.get_frame_info(f);
+                if (frame_info.chunk != (uint32_t)c)
+                    throw std::runtime_error("Corrupt ABO file (inconsistent frame index): " + reader.get_path());
+                cursor.seek(frame_info.offset);
+                records[f] = this->decode_frame_abo(cursor);
+            }
+        } catch (...) {
+            #pragma omp critical
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    // the models own rendering resources and are hence created on this thread
+    std::vector<std::shared_ptr<Frame>> frames;
+    frames.reserve(records.size());
+    for (auto& record : records) {
+        if (!record.structure)
+            throw std::runtime_error("Corrupt ABO file (frame missing from chunks): " + reader.get_path());
+        frames.push_back(this->build_frame(std::move(record)));
+    }
+
+    return frames;
+}
+
+/**
+ * @brief      Decode a single frame record
+ *
+ * The atoms and the vertices are stored as fixed-size records, hence their
+ * bytes are bounds-checked once per array and copied in bulk. Frames are
+ * decoded on worker threads, hence nothing is logged per frame.
+ *
+ * @param      input            ByteCursor or ZstdStream positioned at the
+ *                              start of the frame
+ * @param[in]  abof_version     ABOF version; 0 for the legacy format
+ * @param[in]  normal_encoding  How the vertex normals are stored
+ *
+ * @return     The contents of the frame record
+ */
+template<typename Input>
+ContainerLoader::FrameRecord ContainerLoader::decode_frame(Input& input, uint8_t abof_version, NormalEncoding normal_encoding) const {
+    FrameRecord frame;
+
+    uint16_t frame_idx = 0;
+    input.read(&frame_idx, sizeof(frame_idx));
+
+    // ---- Description ----
+    uint16_t descriptor_length = 0;
+    input.read(&descriptor_length, sizeof(descriptor_length));
+    frame.description.assign(input.view(descriptor_length), descriptor_length);
+
+    std::optional<UnitCellMatrix>& frame_unit_cell = frame.unit_cell;
+    if (abof_version >= 2) {
+        uint8_t frame_flags = 0;
+        input.read(&frame_flags, sizeof(frame_flags));
+        if ((frame_flags & FRAME_UNIT_CELL_FLAG_BIT) != 0) {
+            UnitCellMatrix unit_cell{};
+            input.read(unit_cell.data(), unit_cell.size() * sizeof(float));
+            frame_unit_cell = unit_cell;
+        }
+    }
+
+    // ---- Atoms ----
+    uint16_t nr_atoms = 0;
+    input.read(&nr_atoms, sizeof(nr_atoms));
+
+    // every atom is stored as its element followed by its position
+    constexpr size_t atom_record_size = sizeof(uint8_t) + 3 * sizeof(float);
+    const char* atom_records = input.view(nr_atoms, atom_record_size);
+
+    auto structure = std::make_shared<Structure>();
+    for (uint16_t j = 0; j < nr_atoms; ++j) {
+        const char* record = atom_records + j * atom_record_size;
+        float position[3];
+        std::memcpy(position, record + sizeof(uint8_t), sizeof(position));
+        structure->add_atom(static_cast<uint8_t>(record[0]), position[0], position[1], position[2]);
+    }
+
+    // the unit cell has to be known before the bonds are constructed
+    if (frame_unit_cell)
+        structure->set_unitcell(QMatrix3x3(frame_unit_cell->data()));
+
+    structure->update();
+    frame.structure = structure;
+
+    // ---- Models ----
+    uint16_t nr_models = 0;
+    input.read(&nr_models, sizeof(nr_models));
+
+    for (uint16_t m = 0; m < nr_models; ++m) {
+        uint16_t model_idx = 0;
+        input.read(&model_idx, sizeof(model_idx));
+
+        ModelRecord model;
+        input.read(&model.color[0], 4 * sizeof(float));
+
+        uint32_t nr_vertices = 0;
+        input.read(&nr_vertices, sizeof(nr_vertices));
+
+        // every vertex is stored as its position followed by its normal
+        const size_t normal_size = normal_encoding == NormalEncoding::Float32 ? 3 * sizeof(float) : 2 * sizeof(int16_t);
+        const size_t vertex_record_size = 3 * sizeof(float) + normal_size;
+        const char* vertex_records = input.view(nr_vertices, vertex_record_size);
+
+        model.positions.resize(nr_vertices);
+        model.normals.resize(nr_vertices);
+
+        for (uint32_t k = 0; k < nr_vertices; ++k) {
+            const char* record = vertex_records + k * vertex_record_size;
+            std::memcpy(&model.positions[k][0], record, 3 * sizeof(float));
+            if (normal_encoding == NormalEncoding::Float32) {
+                std::memcpy(&model.normals[k][0], record + 3 * sizeof(float), 3 * sizeof(float));
+            } else {
+                int16_t oct[2];
+                std::memcpy(oct, record + 3 * sizeof(float), sizeof(oct));
+                model.normals[k] = decode_octahedral_normal(oct[0], oct[1]);
+            }
+        }
+
+        uint32_t nr_faces = 0;
+        input.read(&nr_faces, sizeof(nr_faces));
+        const char* face_records = input.view(nr_faces, 3 * sizeof(uint32_t));
+
+        model.indices.resize(static_cast<size_t>(nr_faces) * 3);
+        if (!model.indices.empty())
+            std::memcpy(model.indices.data(), face_records, model.indices.size() * sizeof(uint32_t));
+
+        // empty models are skipped
+        if(nr_vertices > 0 && nr_faces > 0) {
+            frame.models.push_back(std::move(model));
+        }
+    }
+
+    return frame;
+}
+
+/**
+ * @brief      Build a frame and its models from a decoded frame record
+ *
+ * @param      record  The contents of the frame record; moved from
+ *
+ * @return     The frame
+ */
+std::shared_ptr<Frame> ContainerLoader::build_frame(FrameRecord&& record) const {
+    auto frame = std::make_shared<Frame>(record.structure, record.description);
+    frame->set_unit_cell(record.unit_cell);
+
+    for (auto& m : record.models) {
+        auto model = std::make_shared<Model>(std::move(m.positions), std::move(m.normals), std::move(m.indices));
+        model->set_color(m.color);
+        frame->add_model(model);
+    }
+
+    return frame;
 }
@@ -22,16 +22,51 @@
 #ifndef CONTAINER_LOADER_H
 #define CONTAINER_LOADER_H
 
+#include <array>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "container.h"
 #include "atom_settings.h"
+#include "abof_reader.h"
+#include "byte_cursor.h"
+#include "zstd_stream.h"
 
 class ContainerLoader
 {
 private:
+    /**
+     * @brief How the vertex normals of the models are stored
+     */
+    enum class NormalEncoding {
+        Float32,
+        Oct16
+    };
 
 public:
+    /**
+     * @brief Mesh data of a model as stored in a frame record
+     */
+    struct ModelRecord {
+        QVector4D color;
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<uint32_t> indices;
+    };
+
+    /**
+     * @brief Contents of a frame record; decoding these does not create any
+     *        rendering resources and hence can be done on any thread
+     */
+    struct FrameRecord {
+        std::shared_ptr<Structure> structure;
+        std::string description;
+        std::optional<std::array<float, 9>> unit_cell;
+        std::vector<ModelRecord> models;
+    };
+
     /**
      * @brief ContainerLoader constructor
      */
@@ -43,6 +78,69 @@ public:
      * @param[in]  path   Path to file
      */
     std::shared_ptr<Container> load_data_abo(const std::string& path);
+
+    /**
+     * @brief      Decode a frame record of a seekable (version 3) ABOF file
+     *
+     * @param      cursor  Cursor positioned at the start of the frame record
+     *
+     * @return     The contents of the frame record
+     */
+    FrameRecord decode_frame_abo(ByteCursor& cursor) const;
+
+    /**
+     * @brief      Decode a frame record of a compressed (version 1 or 2)
+     *             ABOF file
+     *
+     * @param      stream        Stream positioned at the start of the frame
+     *                           record
+     * @param[in]  abof_version  ABOF version
+     *
+     * @return     The contents of the frame record
+     */
+    FrameRecord decode_frame_stream(ZstdStream& stream, uint8_t abof_version) const;
+
+    /**
+     * @brief      Build a frame and its models from a decoded frame record
+     *
+     * @param      record  The contents of the frame record; moved from
+     *
+     * @return     The frame
+     */
+    std::shared_ptr<Frame> build_frame(FrameRecord&& record) const;
+
+private:
+    /**
+     * @brief      Loads all frames of a seekable (version 3) ABOF file,
+     *             decoding the chunks in parallel
+     *
+     * @param[in]  reader  Reader of the file
+     *
+     * @return     The frames
+     */
+    std::vector<std::shared_ptr<Frame>> load_chunked_frames(const AbofReader& reader) const;
+
+    /**
+     * @brief      Add loaded frames to a container, interpolating between the
+     *             frames of a reaction pathway
+     *
+     * @param      container      The container
+     * @param[in]  loaded_frames  The frames as stored in the file
+     */
+    void add_frames(Container& container, std::vector<std::shared_ptr<Frame>> loaded_frames) const;
+
+    /**
+     * @brief      Decode a single frame record
+     *
+     * @param      input            ByteCursor or ZstdStream positioned at the
+     *                              start of the frame
+     * @param[in]  abof_version     ABOF version; 0 for the legacy format
+     * @param[in]  normal_encoding  How the vertex normals are stored
+     *
+     * @return     The contents of the frame record
+     */
+    template<typename Input>
+    FrameRecord decode_frame(Input& input, uint8_t abof_version, NormalEncoding normal_encoding) const;
 };
 
 #endif // CONTAINER_LOADER_H
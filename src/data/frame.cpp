@@ -30,3 +30,18 @@ Frame::Frame(const std::shared_ptr<Structure>& struc,
              const std::string& _description) :
     structure(struc),
     description(_description) {}
+
+/**
+ * @brief Get the number of bytes occupied by the structure and the models
+ * @return number of bytes
+ */
+size_t Frame::get_memory_size() const {
+    size_t nbytes = sizeof(Frame) + this->description.capacity();
+    if(this->structure) {
+        nbytes += this->structure->get_memory_size();
+    }
+    for(const auto& model : this->models) {
+        nbytes += model->get_memory_size();
+    }
+    return nbytes;
+}
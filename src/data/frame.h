@@ -83,6 +83,12 @@ public:
         return this->models;
     }
 
+    /**
+     * @brief Get the number of bytes occupied by the structure and the models
+     * @return number of bytes
+     */
+    size_t get_memory_size() const;
+
     /**
      * @brief Set optional unit-cell matrix for this frame
      * @param frame_unit_cell row-major 3x3 matrix
@@ -0,0 +1,74 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef FRAME_PROVIDER_H
+#define FRAME_PROVIDER_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+#include "frame.h"
+
+/**
+ * @brief Source of the frames of a container that are decoded on first access
+ *
+ * Decoding a frame is split in two steps: prefetch() decodes the frame data
+ * and can be called from any thread, load_frame() creates the models, which
+ * own rendering resources, and hence has to be called from the gui thread.
+ * Implementations have to be safe to call from both threads simultaneously.
+ */
+class FrameProvider
+{
+public:
+    virtual ~FrameProvider() = default;
+
+    /**
+     * @brief Get the number of frames
+     * @return number of frames
+     */
+    virtual size_t get_nr_frames() const = 0;
+
+    /**
+     * @brief Get the bounding box of a frame without decoding it
+     * @param frame_id frame index
+     * @return smallest and largest coordinates of atoms and vertices, or
+     *         nothing when these are not known yet
+     */
+    virtual std::optional<std::array<float, 6>> get_bounds(size_t frame_id) const = 0;
+
+    /**
+     * @brief Decode a frame ahead of its use, such that a subsequent call to
+     *        load_frame() only has to create its models
+     * @param frame_id frame index
+     */
+    virtual void prefetch(size_t frame_id) = 0;
+
+    /**
+     * @brief Load a frame, using the prefetched frame data when available
+     * @param frame_id frame index
+     * @return frame
+     */
+    virtual std::shared_ptr<Frame> load_frame(size_t frame_id) = 0;
+};
+
+#endif // FRAME_PROVIDER_H
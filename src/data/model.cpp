@@ -27,9 +27,9 @@
  * @param[in]  path  Path to object file
  */
 Model::Model(std::vector<glm::vec3> _positions, std::vector<glm::vec3> _normals, std::vector<uint32_t> _indices) :
-    positions(_positions),
-    normals(_normals),
-    indices(_indices) {
+    positions(std::move(_positions)),
+    normals(std::move(_normals)),
+    indices(std::move(_indices)) {
 
     if(indices.size() < 24) {
         for(const auto& idx : this->indices) {
@@ -67,12 +67,15 @@ void Model::draw() {
 /**
  * @brief      Get maximum vector
  *
+ * @param[in]  offset  Translation applied to the vertices
+ *
  * @return     The maximum vector distance
  */
-glm::vec3 Model::get_max_dim() const {
+glm::vec3 Model::get_max_dim(const glm::vec3& offset) const {
     float maxdist2 = 0.0;
-    glm::vec3 vmax;
-    for(const glm::vec3& v : this->positions) {
+    glm::vec3 vmax(0.0f);
+    for(const glm::vec3& p : this->positions) {
+        const glm::vec3 v = p + offset;
         float dist2 = glm::length2(v);
         if(dist2 > maxdist2) {
             maxdist2 = dist2;
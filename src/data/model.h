@@ -68,9 +68,11 @@ public:
     /**
      * @brief      Get maximum vector
      *
+     * @param[in]  offset  Translation applied to the vertices
+     *
      * @return     The maximum vector distance
      */
-    glm::vec3 get_max_dim() const;
+    glm::vec3 get_max_dim(const glm::vec3& offset = glm::vec3(0.0f)) const;
 
     /**
      * @brief      Load all data to a vertex array object
@@ -101,6 +103,17 @@ public:
         return positions; 
     }
 
+    /**
+     * @brief      Get the number of bytes occupied by the mesh data
+     *
+     * @return     Number of bytes
+     */
+    inline size_t get_memory_size() const {
+        return sizeof(Model) +
+               (this->positions.capacity() + this->normals.capacity()) * sizeof(glm::vec3) +
+               this->indices.capacity() * sizeof(uint32_t);
+    }
+
     inline bool is_loaded() const {
         return this->flag_loaded_vao;
     }
@@ -0,0 +1,87 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef OCTAHEDRAL_NORMAL_H
+#define OCTAHEDRAL_NORMAL_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+/*
+ * Unit vectors are stored by mapping the unit sphere onto an octahedron,
+ * which is unfolded onto the unit square, and quantizing the two resulting
+ * coordinates to 16-bit integers. The same encoding is used for the vertex
+ * normals in ABOF files and in the orbital cache.
+ */
+
+/**
+ * @brief      Encode a unit vector using an octahedral mapping onto two
+ *             16-bit integers
+ *
+ * @param[in]  n     The unit vector
+ *
+ * @return     The encoded vector
+ */
+inline std::array<int16_t, 2> encode_octahedral_normal(const glm::vec3& n) {
+    const float norm = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    glm::vec2 p = norm > 0.0f ? glm::vec2(n.x, n.y) / norm : glm::vec2(0.0f);
+    if(n.z < 0.0f && norm > 0.0f) {
+        const float old_x = p.x;
+        p.x = (1.0f - std::abs(p.y)) * (old_x >= 0.0f ? 1.0f : -1.0f);
+        p.y = (1.0f - std::abs(old_x)) * (p.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    constexpr float scale = 32767.0f;
+    return {
+        static_cast<int16_t>(std::round(glm::clamp(p.x, -1.0f, 1.0f) * scale)),
+        static_cast<int16_t>(std::round(glm::clamp(p.y, -1.0f, 1.0f) * scale))
+    };
+}
+
+/**
+ * @brief      Decode a unit vector from its octahedral mapping
+ *
+ * @param[in]  nx    First encoded coordinate
+ * @param[in]  ny    Second encoded coordinate
+ *
+ * @return     The unit vector
+ */
+inline glm::vec3 decode_octahedral_normal(int16_t nx, int16_t ny) {
+    constexpr float scale = 32767.0f;
+    glm::vec3 n(static_cast<float>(nx) / scale,
+                static_cast<float>(ny) / scale,
+                0.0f);
+    n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
+    if(n.z < 0.0f) {
+        const float old_x = n.x;
+        n.x = (1.0f - std::abs(n.y)) * (old_x >= 0.0f ? 1.0f : -1.0f);
+        n.y = (1.0f - std::abs(old_x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+    if(length > 0.0f) {
+        n /= length;
+    }
+    return n;
+}
+
+#endif // OCTAHEDRAL_NORMAL_H
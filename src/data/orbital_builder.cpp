@@ -21,49 +21,271 @@
 
 #include "orbital_builder.h"
 
-OrbitalBuilder::OrbitalBuilder() {
+namespace {
+
+/**
+ * @brief      Report the start of a stage and check for cancellation
+ *
+ * @param[in]  stage      The stage
+ * @param[in]  level      The refinement level
+ * @param[in]  cancelled  Optional cancellation flag
+ * @param[in]  progress   Optional progress callback
+ *
+ * @return     Whether the construction should continue
+ */
+bool enter_stage(OrbitalBuilder::Stage stage, unsigned int level, const std::atomic<bool>* cancelled,
+                 const OrbitalBuilder::ProgressCallback& progress) {
+    if(cancelled && cancelled->load()) {
+        return false;
+    }
+
+    if(progress) {
+        progress(stage, level);
+    }
+
+    return true;
+}
+
+} // namespace
+
+OrbitalBuilder::OrbitalBuilder() :
+    cache(MESH_VERSION) {
 
 }
 
-void OrbitalBuilder::build_orbital(int n, int l, int m) {
+std::shared_ptr<const OrbitalMeshes> OrbitalBuilder::build_orbital(int n, int l, int m,
+                                                                   const std::atomic<bool>* cancelled,
+                                                                   const ProgressCallback& progress,
+                                                                   const PreviewCallback& preview) {
+    if(!enter_stage(Stage::INTEGRATE, 0, cancelled, progress)) {
+        return nullptr;
+    }
+
     // Constructing wave function and checking that these are normalized
-    qDebug() << "Performing internal integrity checks...";
-    double dummy = 0.0;
     WaveFunction wf(n,l,m);
     Integrator in(&wf);
 
-    // perform some sanity checks on internal routines
-    double radint = in.integrate_radial_density(0, 200, 1e5, &dummy);   // relative high number of points necessary for high principle quantum number orbitals
-    if(!(std::abs(radint - 1.0) < 1e-8)) {
-        throw std::runtime_error("Error. Radial wave function does not integrate up to unity. Sum: " + std::to_string(radint));
-    }
-    double angint = in.integrate_spherical_harmonic(0, M_PI, 5000); // high number of integration points is necessary for higher angular momentum orbitals
+    // perform some sanity checks on internal routines; the quadratures are
+    // exact for hydrogen-like orbitals
+    const double angint = in.integrate_spherical_harmonic();
     if(!(std::abs(angint - 1.0) < 1e-8)) {
         throw std::runtime_error("Error. Angular wave function does not integrate up to unity. Sum: " + std::to_string(angint));
     }
 
-    double r = 0; // reset r value
-    double isovalue = in.find_isosurface_volume(0, 100, 1e5, &r);
-    if(isovalue < 0.0) {
-        isovalue *= -1.0;
+    // the radial properties only depend on n and l and are tabulated
+    RadialProperties radial;
+    {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        auto got = this->radial_properties.find(std::make_pair(n, l));
+        if(got != this->radial_properties.end()) {
+            radial = got->second;
+        } else {
+            qDebug() << "Performing internal integrity checks...";
+            const double radint = in.integrate_radial_density();
+            if(!(std::abs(radint - 1.0) < 1e-8)) {
+                throw std::runtime_error("Error. Radial wave function does not integrate up to unity. Sum: " + std::to_string(radint));
+            }
+
+            radial.isovalue = in.find_isosurface_volume(0.95, &radial.r);
+            if(radial.isovalue < 0.0) {
+                throw std::runtime_error("Error. Could not find the radius enclosing 95% of the radial probability.");
+            }
+
+            this->radial_properties.emplace(std::make_pair(n, l), radial);
+        }
+    }
+    const double isovalue = radial.isovalue;
+    const double r = radial.r;
+
+    // all refinement levels span the same box, such that the meshes of
+    // successive levels coincide up to their resolution
+    const double boxsize = std::ceil(r * 2.0) * 2.0;
+    const unsigned int nr_levels = get_nr_levels();
+    const unsigned int gridsize = get_gridsize(nr_levels - 1);
+    const double resolution = boxsize / (double)(gridsize - 1);
+
+    // re-use earlier constructed meshes; the grid itself is only sampled
+    // again once the isovalue is changed
+    const OrbitalCacheKey key{n, l, m, gridsize, resolution, isovalue, MESH_VERSION};
+    {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        this->grid = OrbitalGrid{n, l, m, gridsize, resolution, isovalue, nullptr};
+
+        auto meshes = this->cache.find(key);
+        if(meshes) {
+            return meshes;
+        }
+    }
+
+    // provide quick previews on the coarser grids
+    if(preview) {
+        for(unsigned int level=0; level<nr_levels-1; level++) {
+            if(!enter_stage(Stage::SAMPLE, level, cancelled, progress)) {
+                return nullptr;
+            }
+
+            const unsigned int coarse_gridsize = get_gridsize(level);
+            auto field = this->sample_field(wf, coarse_gridsize, boxsize / (double)(coarse_gridsize - 1));
+            auto meshes = this->extract_meshes(*field, isovalue, level, cancelled, progress);
+            if(!meshes) {
+                return nullptr;
+            }
+            preview(meshes);
+        }
+    }
+
+    if(!enter_stage(Stage::SAMPLE, nr_levels - 1, cancelled, progress)) {
+        return nullptr;
+    }
+    auto field = this->sample_field(wf, gridsize, resolution);
+    this->store_field(n, l, m, field);
+
+    auto meshes = this->extract_meshes(*field, isovalue, nr_levels - 1, cancelled, progress);
+    if(meshes) {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        this->cache.insert(key, meshes);
     }
 
-    unsigned int gridsize = 151;
-    double resolution = std::ceil(r * 2.0) * 2.0 / (double)gridsize;
-    ScalarField sf(gridsize, resolution);
-    sf.load_wavefunction(wf, true); // second argument determines whether wavefunction is loaded in a signed fashion
+    return meshes;
+}
+
+/**
+ * @brief      Re-extract the meshes of the orbital built last at another
+ *             isovalue
+ *
+ * @param[in]  scale      Isovalue relative to the one enclosing 95% of the
+ *                        probability
+ * @param[in]  cancelled  Optional flag to abort the construction
+ * @param[in]  progress   Optional callback invoked at the start of each stage
+ *
+ * @return     The meshes or nullptr when no orbital has been built or the
+ *             construction was cancelled
+ */
+std::shared_ptr<const OrbitalMeshes> OrbitalBuilder::change_isovalue(double scale,
+                                                                     const std::atomic<bool>* cancelled,
+                                                                     const ProgressCallback& progress) {
+    OrbitalGrid current;
+    {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        current = this->grid;
+    }
+
+    if(current.gridsize == 0) {
+        return nullptr;
+    }
+
+    // the grid is not available when the meshes were taken from the cache
+    const unsigned int level = get_nr_levels() - 1;
+    if(!current.field) {
+        if(!enter_stage(Stage::SAMPLE, level, cancelled, progress)) {
+            return nullptr;
+        }
+
+        WaveFunction wf(current.n, current.l, current.m);
+        current.field = this->sample_field(wf, current.gridsize, current.resolution);
+        this->store_field(current.n, current.l, current.m, current.field);
+    }
+
+    return this->extract_meshes(*current.field, current.isovalue * scale, level, cancelled, progress);
+}
+
+/**
+ * @brief      Get a human-readable description of a stage
+ *
+ * @param[in]  stage  The stage
+ *
+ * @return     The description
+ */
+const char* OrbitalBuilder::get_stage_description(Stage stage) {
+    switch(stage) {
+        case Stage::INTEGRATE:
+            return "checking integrals";
+        case Stage::SAMPLE:
+            return "sampling wave function";
+        case Stage::EXTRACT:
+            return "extracting isosurfaces";
+        case Stage::NORMALS:
+            return "calculating normals";
+        default:
+            return "";
+    }
+}
+
+/**
+ * @brief      Sample a wave function on a grid centered at the nucleus
+ *
+ * @param[in]  wf          The wave function
+ * @param[in]  gridsize    Number of grid points along each axis
+ * @param[in]  resolution  Grid spacing
+ *
+ * @return     The scalar field
+ */
+std::shared_ptr<const ScalarField> OrbitalBuilder::sample_field(const WaveFunction& wf, unsigned int gridsize,
+                                                                double resolution) const {
+    // the isosurface extraction compares values in single precision, hence
+    // storing the field in single precision loses nothing
+    auto sf = std::make_shared<ScalarField>(gridsize, resolution,
+                                            GridStorage::Precision::FLOAT,
+                                            GridStorage::Layout::BRICKED);
+    sf->load_wavefunction(wf, true); // second argument determines whether wavefunction is loaded in a signed fashion
+    return sf;
+}
+
+/**
+ * @brief      Keep the grid of the orbital built last
+ *
+ * @param[in]  n      Principal quantum number
+ * @param[in]  l      Azimuthal quantum number
+ * @param[in]  m      Magnetic quantum number
+ * @param[in]  field  The scalar field
+ */
+void OrbitalBuilder::store_field(int n, int l, int m, const std::shared_ptr<const ScalarField>& field) {
+    std::lock_guard<std::mutex> lock(this->cache_mutex);
+    if(this->grid.n == n && this->grid.l == l && this->grid.m == m) {
+        this->grid.field = field;
+    }
+}
+
+/**
+ * @brief      Extract the meshes of the positive and negative lobes
+ *
+ * @param[in]  sf          The scalar field
+ * @param[in]  isovalue    Isovalue of the positive lobe
+ * @param[in]  level       Refinement level, used for progress reporting
+ * @param[in]  cancelled   Optional flag to abort the construction
+ * @param[in]  progress    Optional progress callback
+ *
+ * @return     The meshes or nullptr when the construction was cancelled
+ */
+std::shared_ptr<const OrbitalMeshes> OrbitalBuilder::extract_meshes(const ScalarField& sf, double isovalue,
+                                                                    unsigned int level,
+                                                                    const std::atomic<bool>* cancelled,
+                                                                    const ProgressCallback& progress) const {
+    if(!enter_stage(Stage::EXTRACT, level, cancelled, progress)) {
+        return nullptr;
+    }
 
     // analyze the grid and generate the isosurface using the isovalue
     qDebug() << "Constructing isosurface";
 
-    // build isosurfaces
-    IsoSurface is_pos(&sf);
-    IsoSurface is_neg(&sf);
-    is_pos.marching_cubes(isovalue);
-    is_neg.marching_cubes(-isovalue);
+    // build the positive and negative lobes in a single pass over the grid
+    IsoSurface is(&sf);
+    is.set_nr_threads(this->nr_threads);
+    is.marching_cubes({(float)isovalue, (float)-isovalue});
+
+    if(!enter_stage(Stage::NORMALS, level, cancelled, progress)) {
+        return nullptr;
+    }
+
+    auto result = std::make_shared<OrbitalMeshes>();
+    OrbitalMesh* lobes[2] = {&result->pos, &result->neg};
+    for(unsigned int i=0; i<2; i++) {
+        IsoSurfaceMesh mesh(&sf, &is, i);
+        mesh.construct_mesh(true);
+        lobes[i]->vertices = mesh.get_vertices();
+        lobes[i]->normals = mesh.get_normals();
+        lobes[i]->indices = mesh.get_indices();
+    }
 
-    this->pos = std::make_unique<IsoSurfaceMesh>(&sf, &is_pos);
-    this->pos->construct_mesh(true);
-    this->neg = std::make_unique<IsoSurfaceMesh>(&sf, &is_neg);
-    this->neg->construct_mesh(true);
+    return result;
 }
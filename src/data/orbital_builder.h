@@ -21,36 +21,196 @@
 
 #include <QDebug>
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
 #include "orbitals/scalar_field.h"
 #include "orbitals/isosurface_mesh.h"
 #include "orbitals/wavefunction.h"
 #include "orbitals/integrator.h"
+#include "orbital_cache.h"
 
 class OrbitalBuilder {
+public:
+    /**
+     * @brief      Stages of the orbital construction, reported in order
+     */
+    enum class Stage {
+        INTEGRATE,      // integrity checks and isovalue determination
+        SAMPLE,         // sampling the wave function on the grid
+        EXTRACT,        // extracting the welded isosurfaces of both lobes
+        NORMALS,        // constructing the lobe meshes and their normals
+        NR_STAGES
+    };
+
+    typedef std::function<void(Stage, unsigned int)> ProgressCallback;
+    typedef std::function<void(const std::shared_ptr<const OrbitalMeshes>&)> PreviewCallback;
+
 private:
-    std::unique_ptr<IsoSurfaceMesh> pos;
-    std::unique_ptr<IsoSurfaceMesh> neg;
+    /**
+     * @brief      Radial properties of an orbital, shared by all magnetic
+     *             quantum numbers
+     */
+    struct RadialProperties {
+        double isovalue;    // isovalue of the surface enclosing 95% of the probability
+        double r;           // radius enclosing 95% of the probability
+    };
+
+    /**
+     * @brief      Grid of the orbital built last, kept to re-extract its
+     *             isosurfaces at other isovalues
+     */
+    struct OrbitalGrid {
+        int n = 0;
+        int l = 0;
+        int m = 0;
+        unsigned int gridsize = 0;                  // zero when no orbital has been built
+        double resolution = 0.0;
+        double isovalue = 0.0;                      // isovalue enclosing 95% of the probability
+        std::shared_ptr<const ScalarField> field;   // sampled on demand
+    };
+
+    OrbitalCache cache;
+    std::map<std::pair<int,int>, RadialProperties> radial_properties;  // tabulated per (n,l)
+    OrbitalGrid grid;
+    std::mutex cache_mutex;         // guards the caches and grid when orbitals are built concurrently
+    unsigned int nr_threads = 0;    // threads used for isosurface construction; 0 uses all available
+
+    // version of the mesh construction; increase whenever the generated
+    // meshes change such that stale entries in the disk cache are removed
+    static const uint32_t MESH_VERSION = 2;
+
+    // number of grid points along each axis for the successive refinement
+    // levels; every level spans the same box around the nucleus
+    static constexpr unsigned int GRID_SCHEDULE[] = {41, 81, 151};
 
 public:
     OrbitalBuilder();
 
-    void build_orbital(int n, int l, int m);
+    /**
+     * @brief      Build the meshes of the positive and negative lobes of an
+     *             orbital
+     *
+     * The orbital is refined progressively over the levels of the grid
+     * schedule. The meshes of all but the finest level are passed to the
+     * preview callback as soon as they are ready, unless the finest meshes
+     * are readily available from the cache.
+     *
+     * This function may be called from a worker thread. The cancellation flag
+     * is checked in between the stages of the construction.
+     *
+     * @param[in]  n          Principal quantum number
+     * @param[in]  l          Azimuthal quantum number
+     * @param[in]  m          Magnetic quantum number
+     * @param[in]  cancelled  Optional flag to abort the construction
+     * @param[in]  progress   Optional callback invoked at the start of each
+     *                        stage with the refinement level
+     * @param[in]  preview    Optional callback receiving the coarse meshes
+     *
+     * @return     The meshes of the finest level or nullptr when the
+     *             construction was cancelled
+     */
+    std::shared_ptr<const OrbitalMeshes> build_orbital(int n, int l, int m,
+                                                       const std::atomic<bool>* cancelled = nullptr,
+                                                       const ProgressCallback& progress = ProgressCallback(),
+                                                       const PreviewCallback& preview = PreviewCallback());
 
-    inline size_t get_num_pos_vertices() const {
-        return this->pos->get_num_vertices();
-    }
+    /**
+     * @brief      Re-extract the meshes of the orbital built last at another
+     *             isovalue
+     *
+     * The grid of the finest refinement level is kept alive after a build,
+     * such that only the extraction is repeated. Its min/max bricks restrict
+     * the extraction to the regions straddling the isovalue.
+     *
+     * @param[in]  scale      Isovalue relative to the one enclosing 95% of the
+     *                        probability
+     * @param[in]  cancelled  Optional flag to abort the construction
+     * @param[in]  progress   Optional callback invoked at the start of each stage
+     *
+     * @return     The meshes or nullptr when no orbital has been built or the
+     *             construction was cancelled
+     */
+    std::shared_ptr<const OrbitalMeshes> change_isovalue(double scale,
+                                                         const std::atomic<bool>* cancelled = nullptr,
+                                                         const ProgressCallback& progress = ProgressCallback());
 
-    inline size_t get_num_neg_vertices() const {
-        return this->neg->get_num_vertices();
+    /**
+     * @brief      Set the number of threads used for the isosurface construction
+     *
+     * @param[in]  _nr_threads  Number of threads; 0 uses all available threads
+     */
+    inline void set_nr_threads(unsigned int _nr_threads) {
+        this->nr_threads = _nr_threads;
     }
 
-    inline const IsoSurfaceMesh* get_pos() const {
-        return this->pos.get();
+    /**
+     * @brief      Get a human-readable description of a stage
+     *
+     * @param[in]  stage  The stage
+     *
+     * @return     The description
+     */
+    static const char* get_stage_description(Stage stage);
+
+    /**
+     * @brief      Get the number of refinement levels
+     *
+     * @return     Number of levels
+     */
+    static inline unsigned int get_nr_levels() {
+        return sizeof(GRID_SCHEDULE) / sizeof(GRID_SCHEDULE[0]);
     }
 
-    inline const IsoSurfaceMesh* get_neg() const {
-        return this->neg.get();
+    /**
+     * @brief      Get the number of grid points along each axis of a
+     *             refinement level
+     *
+     * @param[in]  level  The refinement level
+     *
+     * @return     Number of grid points
+     */
+    static inline unsigned int get_gridsize(unsigned int level) {
+        return GRID_SCHEDULE[level];
     }
 
 private:
+    /**
+     * @brief      Sample a wave function on a grid centered at the nucleus
+     *
+     * @param[in]  wf          The wave function
+     * @param[in]  gridsize    Number of grid points along each axis
+     * @param[in]  resolution  Grid spacing
+     *
+     * @return     The scalar field
+     */
+    std::shared_ptr<const ScalarField> sample_field(const WaveFunction& wf, unsigned int gridsize,
+                                                    double resolution) const;
+
+    /**
+     * @brief      Keep the grid of the orbital built last
+     *
+     * @param[in]  n      Principal quantum number
+     * @param[in]  l      Azimuthal quantum number
+     * @param[in]  m      Magnetic quantum number
+     * @param[in]  field  The scalar field
+     */
+    void store_field(int n, int l, int m, const std::shared_ptr<const ScalarField>& field);
+
+    /**
+     * @brief      Extract the meshes of the positive and negative lobes
+     *
+     * @param[in]  sf          The scalar field
+     * @param[in]  isovalue    Isovalue of the positive lobe
+     * @param[in]  level       Refinement level, used for progress reporting
+     * @param[in]  cancelled   Optional flag to abort the construction
+     * @param[in]  progress    Optional progress callback
+     *
+     * @return     The meshes or nullptr when the construction was cancelled
+     */
+    std::shared_ptr<const OrbitalMeshes> extract_meshes(const ScalarField& sf, double isovalue, unsigned int level,
+                                                        const std::atomic<bool>* cancelled,
+                                                        const ProgressCallback& progress) const;
 };
@@ -0,0 +1,424 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+
+#include "orbital_cache.h"
+#include "octahedral_normal.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <zstd.h>
+
+namespace {
+
+const char CACHE_MAGIC[4] = {'M', 'G', 'O', 'C'};
+const uint8_t CACHE_FORMAT_VERSION = 1;
+
+/**
+ * @brief      Append raw little endian data to a buffer
+ */
+template<typename T>
+void append(std::string& buffer, const T* data, size_t count) {
+    buffer.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+/**
+ * @brief      Sequential reader of raw data with bounds checking
+ */
+class PayloadReader {
+private:
+    const std::string& data;
+    size_t pos = 0;
+
+public:
+    PayloadReader(const std::string& _data) : data(_data) {}
+
+    size_t get_remaining() const {
+        return this->data.size() - this->pos;
+    }
+
+    template<typename T>
+    void read(T* out, size_t count) {
+        const size_t size = count * sizeof(T);
+        if(size > this->data.size() - this->pos) {
+            throw std::runtime_error("Truncated orbital cache file");
+        }
+        std::memcpy(out, this->data.data() + this->pos, size);
+        this->pos += size;
+    }
+
+    template<typename T>
+    T read() {
+        T value;
+        this->read(&value, 1);
+        return value;
+    }
+};
+
+/**
+ * @brief      Append the key to a buffer
+ */
+void write_key(std::string& buffer, const OrbitalCacheKey& key) {
+    const int32_t quantum_numbers[3] = {key.n, key.l, key.m};
+    const uint32_t gridsize = key.gridsize;
+    append(buffer, quantum_numbers, 3);
+    append(buffer, &gridsize, 1);
+    append(buffer, &key.resolution, 1);
+    append(buffer, &key.isovalue, 1);
+    append(buffer, &key.version, 1);
+}
+
+/**
+ * @brief      Read a key from a buffer
+ */
+OrbitalCacheKey read_key(PayloadReader& reader) {
+    OrbitalCacheKey key;
+    int32_t quantum_numbers[3];
+    reader.read(quantum_numbers, 3);
+    key.n = quantum_numbers[0];
+    key.l = quantum_numbers[1];
+    key.m = quantum_numbers[2];
+    key.gridsize = reader.read<uint32_t>();
+    key.resolution = reader.read<double>();
+    key.isovalue = reader.read<double>();
+    key.version = reader.read<uint32_t>();
+    return key;
+}
+
+/**
+ * @brief      Append a mesh to a buffer, encoding the normals using 16 bits
+ *             per component
+ */
+void write_mesh(std::string& buffer, const OrbitalMesh& mesh) {
+    const uint32_t nr_vertices = mesh.vertices.size();
+    const uint32_t nr_indices = mesh.indices.size();
+    append(buffer, &nr_vertices, 1);
+    append(buffer, &nr_indices, 1);
+
+    for(const auto& v : mesh.vertices) {
+        const float xyz[3] = {v.x, v.y, v.z};
+        append(buffer, xyz, 3);
+    }
+
+    for(const auto& n : mesh.normals) {
+        const auto encoded = encode_octahedral_normal(n);
+        append(buffer, encoded.data(), 2);
+    }
+
+    for(unsigned int idx : mesh.indices) {
+        const uint32_t value = idx;
+        append(buffer, &value, 1);
+    }
+}
+
+/**
+ * @brief      Read a mesh from a buffer
+ */
+void read_mesh(PayloadReader& reader, OrbitalMesh& mesh) {
+    const uint32_t nr_vertices = reader.read<uint32_t>();
+    const uint32_t nr_indices = reader.read<uint32_t>();
+
+    // verify the counts before allocating any storage for them
+    const uint64_t size = (uint64_t)nr_vertices * (3 * sizeof(float) + 2 * sizeof(int16_t)) +
+                          (uint64_t)nr_indices * sizeof(uint32_t);
+    if(size > reader.get_remaining()) {
+        throw std::runtime_error("Truncated orbital cache file");
+    }
+
+    std::vector<float> positions(nr_vertices * 3);
+    reader.read(positions.data(), positions.size());
+    mesh.vertices.resize(nr_vertices);
+    for(uint32_t i=0; i<nr_vertices; i++) {
+        mesh.vertices[i] = glm::vec3(positions[i*3], positions[i*3+1], positions[i*3+2]);
+    }
+
+    std::vector<int16_t> normals(nr_vertices * 2);
+    reader.read(normals.data(), normals.size());
+    mesh.normals.resize(nr_vertices);
+    for(uint32_t i=0; i<nr_vertices; i++) {
+        mesh.normals[i] = decode_octahedral_normal(normals[i*2], normals[i*2+1]);
+    }
+
+    std::vector<uint32_t> indices(nr_indices);
+    reader.read(indices.data(), indices.size());
+    mesh.indices.assign(indices.begin(), indices.end());
+    for(unsigned int idx : mesh.indices) {
+        if(idx >= nr_vertices) {
+            throw std::runtime_error("Invalid vertex index in orbital cache file");
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief      Get the number of bytes occupied by the meshes
+ *
+ * @return     Number of bytes
+ */
+size_t OrbitalMeshes::get_memory_size() const {
+    size_t size = 0;
+    for(const OrbitalMesh* mesh : {&this->pos, &this->neg}) {
+        size += (mesh->vertices.size() + mesh->normals.size()) * sizeof(glm::vec3) +
+                mesh->indices.size() * sizeof(unsigned int);
+    }
+    return size;
+}
+
+/**
+ * @brief      Get the name of the file storing the meshes on disk
+ *
+ * The floating point parameters are encoded by their bit patterns such that
+ * the file is only found for exactly the same parameters.
+ *
+ * @return     The filename
+ */
+QString OrbitalCacheKey::get_filename() const {
+    uint64_t resolution_bits = 0;
+    uint64_t isovalue_bits = 0;
+    std::memcpy(&resolution_bits, &this->resolution, sizeof(double));
+    std::memcpy(&isovalue_bits, &this->isovalue, sizeof(double));
+
+    return QString("orbital_%1_%2_%3_%4_%5_%6_v%7.bin")
+        .arg(this->n)
+        .arg(this->l)
+        .arg(this->m)
+        .arg(this->gridsize)
+        .arg(resolution_bits, 16, 16, QChar('0'))
+        .arg(isovalue_bits, 16, 16, QChar('0'))
+        .arg(this->version);
+}
+
+/**
+ * @brief      Constructs a new instance and prunes the disk cache
+ *
+ * @param[in]  _version          Version of the mesh construction
+ * @param[in]  _max_memory_size  Maximum number of bytes held in memory
+ * @param[in]  _max_disk_size    Maximum number of bytes held on disk
+ */
+OrbitalCache::OrbitalCache(uint32_t _version, size_t _max_memory_size, size_t _max_disk_size) :
+    max_memory_size(_max_memory_size),
+    max_disk_size(_max_disk_size),
+    version(_version) {
+
+    const QString cache_location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(!cache_location.isEmpty()) {
+        this->directory = QDir(cache_location).filePath("orbitals");
+        this->prune_disk();
+    }
+}
+
+/**
+ * @brief      Find the meshes of an orbital in memory or on disk
+ *
+ * @param[in]  key   The key
+ *
+ * @return     The meshes or a null pointer when not cached
+ */
+std::shared_ptr<const OrbitalMeshes> OrbitalCache::find(const OrbitalCacheKey& key) {
+    auto got = this->lookup.find(key);
+    if(got != this->lookup.end()) {
+        // mark as most recently used
+        this->entries.splice(this->entries.begin(), this->entries, got->second);
+        return got->second->second;
+    }
+
+    auto meshes = this->load_from_disk(key);
+    if(meshes) {
+        this->insert_in_memory(key, meshes);
+    }
+
+    return meshes;
+}
+
+/**
+ * @brief      Store the meshes of an orbital in memory and on disk
+ *
+ * @param[in]  key     The key
+ * @param[in]  meshes  The meshes
+ */
+void OrbitalCache::insert(const OrbitalCacheKey& key, const std::shared_ptr<const OrbitalMeshes>& meshes) {
+    this->insert_in_memory(key, meshes);
+    this->store_to_disk(key, *meshes);
+}
+
+/**
+ * @brief      Add meshes to the in-memory cache, evicting the least recently
+ *             used meshes when exceeding the memory budget
+ *
+ * @param[in]  key     The key
+ * @param[in]  meshes  The meshes
+ */
+void OrbitalCache::insert_in_memory(const OrbitalCacheKey& key, const std::shared_ptr<const OrbitalMeshes>& meshes) {
+    auto got = this->lookup.find(key);
+    if(got != this->lookup.end()) {
+        this->memory_size -= got->second->second->get_memory_size();
+        this->entries.erase(got->second);
+        this->lookup.erase(got);
+    }
+
+    this->entries.emplace_front(key, meshes);
+    this->lookup[key] = this->entries.begin();
+    this->memory_size += meshes->get_memory_size();
+
+    // always retain the most recent entry
+    while(this->memory_size > this->max_memory_size && this->entries.size() > 1) {
+        this->memory_size -= this->entries.back().second->get_memory_size();
+        this->lookup.erase(this->entries.back().first);
+        this->entries.pop_back();
+    }
+}
+
+/**
+ * @brief      Load meshes from the disk cache
+ *
+ * @param[in]  key   The key
+ *
+ * @return     The meshes or a null pointer when not available
+ */
+std::shared_ptr<const OrbitalMeshes> OrbitalCache::load_from_disk(const OrbitalCacheKey& key) const {
+    if(this->directory.isEmpty()) {
+        return nullptr;
+    }
+
+    QFile file(QDir(this->directory).filePath(key.get_filename()));
+    if(!file.exists()) {
+        return nullptr;
+    }
+
+    try {
+        if(!file.open(QIODevice::ReadOnly)) {
+            throw std::runtime_error("Cannot open file");
+        }
+        const QByteArray data = file.readAll();
+        const size_t header_size = sizeof(CACHE_MAGIC) + sizeof(CACHE_FORMAT_VERSION);
+        if((size_t)data.size() < header_size ||
+           std::memcmp(data.constData(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+           (uint8_t)data[sizeof(CACHE_MAGIC)] != CACHE_FORMAT_VERSION) {
+            throw std::runtime_error("Unsupported header");
+        }
+
+        const char* compressed = data.constData() + header_size;
+        const size_t compressed_size = data.size() - header_size;
+        const unsigned long long content_size = ZSTD_getFrameContentSize(compressed, compressed_size);
+        if(content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+            throw std::runtime_error("Invalid zstd payload");
+        }
+
+        std::string payload(content_size, '\0');
+        const size_t result = ZSTD_decompress(&payload[0], payload.size(), compressed, compressed_size);
+        if(ZSTD_isError(result) || result != payload.size()) {
+            throw std::runtime_error("Cannot decompress payload");
+        }
+
+        PayloadReader reader(payload);
+        if(!(read_key(reader) == key)) {
+            throw std::runtime_error("Mismatching orbital parameters");
+        }
+
+        auto meshes = std::make_shared<OrbitalMeshes>();
+        read_mesh(reader, meshes->pos);
+        read_mesh(reader, meshes->neg);
+
+        qDebug() << "Loaded orbital meshes from cache:" << file.fileName();
+        return meshes;
+    } catch(const std::exception& e) {
+        qWarning() << "Ignoring orbital cache file" << file.fileName() << ":" << e.what();
+        return nullptr;
+    }
+}
+
+/**
+ * @brief      Store meshes in the disk cache
+ *
+ * @param[in]  key     The key
+ * @param[in]  meshes  The meshes
+ */
+void OrbitalCache::store_to_disk(const OrbitalCacheKey& key, const OrbitalMeshes& meshes) const {
+    if(this->directory.isEmpty()) {
+        return;
+    }
+
+    if(!QDir().mkpath(this->directory)) {
+        qWarning() << "Cannot create orbital cache directory" << this->directory;
+        return;
+    }
+
+    std::string payload;
+    write_key(payload, key);
+    write_mesh(payload, meshes.pos);
+    write_mesh(payload, meshes.neg);
+
+    std::string compressed(ZSTD_compressBound(payload.size()), '\0');
+    const size_t compressed_size = ZSTD_compress(&compressed[0], compressed.size(),
+                                                 payload.data(), payload.size(), 3);
+    if(ZSTD_isError(compressed_size)) {
+        qWarning() << "Cannot compress orbital meshes:" << ZSTD_getErrorName(compressed_size);
+        return;
+    }
+
+    // write to a temporary file first such that a partially written file
+    // never ends up in the cache
+    QSaveFile file(QDir(this->directory).filePath(key.get_filename()));
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write orbital cache file" << file.fileName();
+        return;
+    }
+    file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&CACHE_FORMAT_VERSION), sizeof(CACHE_FORMAT_VERSION));
+    file.write(compressed.data(), compressed_size);
+    if(!file.commit()) {
+        qWarning() << "Cannot write orbital cache file" << file.fileName();
+    }
+}
+
+/**
+ * @brief      Remove the files of other mesh versions from the disk cache,
+ *             as well as the oldest files exceeding the disk budget
+ */
+void OrbitalCache::prune_disk() const {
+    const QString suffix = QString("_v%1.bin").arg(this->version);
+
+    // most recently written files first
+    const QFileInfoList files = QDir(this->directory).entryInfoList(QStringList() << "orbital_*.bin",
+                                                                    QDir::Files, QDir::Time);
+    size_t disk_size = 0;
+    for(const QFileInfo& info : files) {
+        if(info.fileName().endsWith(suffix)) {
+            disk_size += info.size();
+            if(disk_size <= this->max_disk_size) {
+                continue;
+            }
+        }
+
+        if(!QFile::remove(info.filePath())) {
+            qWarning() << "Cannot remove orbital cache file" << info.filePath();
+        }
+    }
+}
@@ -0,0 +1,194 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+
+#ifndef _ORBITAL_CACHE_H
+#define _ORBITAL_CACHE_H
+
+#include <QString>
+#include <QDebug>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief      Finished mesh of a single orbital lobe
+ */
+class OrbitalMesh {
+public:
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+    std::vector<unsigned int> indices;
+
+    inline const auto& get_vertices() const {
+        return this->vertices;
+    }
+
+    inline const auto& get_normals() const {
+        return this->normals;
+    }
+
+    inline const auto& get_indices() const {
+        return this->indices;
+    }
+
+    inline size_t get_num_vertices() const {
+        return this->vertices.size();
+    }
+};
+
+/**
+ * @brief      Meshes of the positive and negative lobes of an orbital
+ */
+struct OrbitalMeshes {
+    OrbitalMesh pos;
+    OrbitalMesh neg;
+
+    /**
+     * @brief      Get the number of bytes occupied by the meshes
+     *
+     * @return     Number of bytes
+     */
+    size_t get_memory_size() const;
+};
+
+/**
+ * @brief      Parameters fully determining the meshes of an orbital
+ */
+struct OrbitalCacheKey {
+    int n, l, m;                // quantum numbers
+    unsigned int gridsize;      // number of grid points along each axis
+    double resolution;          // grid spacing
+    double isovalue;            // isovalue of the positive lobe
+    uint32_t version;           // version of the mesh construction algorithm
+
+    inline bool operator<(const OrbitalCacheKey& other) const {
+        return std::tie(n, l, m, gridsize, resolution, isovalue, version) <
+               std::tie(other.n, other.l, other.m, other.gridsize, other.resolution, other.isovalue, other.version);
+    }
+
+    inline bool operator==(const OrbitalCacheKey& other) const {
+        return !(*this < other) && !(other < *this);
+    }
+
+    /**
+     * @brief      Get the name of the file storing the meshes on disk
+     *
+     * @return     The filename
+     */
+    QString get_filename() const;
+};
+
+/**
+ * @brief      Cache of finished orbital meshes
+ *
+ * Meshes are kept in memory in least-recently-used order up to a maximum
+ * number of bytes and are furthermore stored as zstd-compressed binary files
+ * in the user cache directory, such that they survive restarts of the
+ * program. Files written by other versions of the mesh construction and the
+ * oldest files exceeding the disk budget are removed upon construction.
+ * Failures to read or write the disk cache are reported, but
+ * otherwise ignored.
+ */
+class OrbitalCache {
+private:
+    using Entry = std::pair<OrbitalCacheKey, std::shared_ptr<const OrbitalMeshes>>;
+
+    std::list<Entry> entries;                                           // most recently used first
+    std::map<OrbitalCacheKey, std::list<Entry>::iterator> lookup;       // position of the keys in the list
+    size_t memory_size = 0;                                             // bytes held in memory
+    size_t max_memory_size;                                             // maximum bytes held in memory
+    size_t max_disk_size;                                               // maximum bytes held on disk
+    uint32_t version;                                                   // version of the meshes kept on disk
+    QString directory;                                                  // disk cache directory
+
+public:
+    /**
+     * @brief      Constructs a new instance and prunes the disk cache
+     *
+     * @param[in]  _version          Version of the mesh construction
+     * @param[in]  _max_memory_size  Maximum number of bytes held in memory
+     * @param[in]  _max_disk_size    Maximum number of bytes held on disk
+     */
+    OrbitalCache(uint32_t _version,
+                 size_t _max_memory_size = 256 * 1024 * 1024,
+                 size_t _max_disk_size = 512 * 1024 * 1024);
+
+    /**
+     * @brief      Find the meshes of an orbital in memory or on disk
+     *
+     * @param[in]  key   The key
+     *
+     * @return     The meshes or a null pointer when not cached
+     */
+    std::shared_ptr<const OrbitalMeshes> find(const OrbitalCacheKey& key);
+
+    /**
+     * @brief      Store the meshes of an orbital in memory and on disk
+     *
+     * @param[in]  key     The key
+     * @param[in]  meshes  The meshes
+     */
+    void insert(const OrbitalCacheKey& key, const std::shared_ptr<const OrbitalMeshes>& meshes);
+
+private:
+    /**
+     * @brief      Add meshes to the in-memory cache, evicting the least
+     *             recently used meshes when exceeding the memory budget
+     *
+     * @param[in]  key     The key
+     * @param[in]  meshes  The meshes
+     */
+    void insert_in_memory(const OrbitalCacheKey& key, const std::shared_ptr<const OrbitalMeshes>& meshes);
+
+    /**
+     * @brief      Load meshes from the disk cache
+     *
+     * @param[in]  key   The key
+     *
+     * @return     The meshes or a null pointer when not available
+     */
+    std::shared_ptr<const OrbitalMeshes> load_from_disk(const OrbitalCacheKey& key) const;
+
+    /**
+     * @brief      Store meshes in the disk cache
+     *
+     * @param[in]  key     The key
+     * @param[in]  meshes  The meshes
+     */
+    void store_to_disk(const OrbitalCacheKey& key, const OrbitalMeshes& meshes) const;
+
+    /**
+     * @brief      Remove the files of other mesh versions from the disk
+     *             cache, as well as the oldest files exceeding the disk
+     *             budget
+     */
+    void prune_disk() const;
+};
+
+#endif // _ORBITAL_CACHE_H
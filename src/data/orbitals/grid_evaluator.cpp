@@ -0,0 +1,221 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+
+#include "grid_evaluator.h"
+
+/**
+ * @brief      Constructs a new instance.
+ *
+ * @param[in]  wf     The wave function
+ * @param[in]  _rmax  Largest distance to the origin to evaluate
+ */
+GridEvaluator::GridEvaluator(const WaveFunction& wf, double _rmax) :
+    l(wf.get_l()),
+    am(std::abs(wf.get_m())),
+    m(wf.get_m()),
+    rmax(_rmax > 0.0 ? _rmax : 1.0) {
+
+    // r^l P_l^|m|(cos theta) {cos,sin}(|m| phi) equals
+    // (-1)^|m| (2|m|-1)!! Re,Im[(x+iy)^|m|] Pi_l^|m|(z, r^2), wherein the
+    // polynomial Pi follows the recurrence of the Legendre polynomials
+    double double_factorial = 1.0;
+    for(int k=1; k<2*this->am; k+=2) {
+        double_factorial *= (double)k;
+    }
+    this->angular_prefactor = wf.get_polar_prefactor() / std::sqrt(4.0 * M_PI) *
+                              (this->am % 2 == 0 ? 1.0 : -1.0) * double_factorial;
+
+    for(int j=this->am+1; j<=this->l; j++) {
+        this->recurrence_a.push_back((double)(2 * j - 1) / (double)(j - this->am));
+        this->recurrence_b.push_back((double)(j + this->am - 1) / (double)(j - this->am));
+    }
+
+    // tabulate the radial part using cubic Hermite interpolation between
+    // the exact values and derivatives at the knots
+    const double h = this->rmax / (double)NR_INTERVALS;
+    this->inv_h = 1.0 / h;
+    this->spline.resize(NR_INTERVALS * 4);
+
+    double df0 = 0.0;
+    double f0 = radial_function(wf, 0.0, &df0);
+    for(unsigned int i=0; i<NR_INTERVALS; i++) {
+        double df1 = 0.0;
+        const double f1 = radial_function(wf, (double)(i+1) * h, &df1);
+
+        double* c = &this->spline[i * 4];
+        c[0] = f0;
+        c[1] = h * df0;
+        c[2] = 3.0 * (f1 - f0) - h * (2.0 * df0 + df1);
+        c[3] = 2.0 * (f0 - f1) + h * (df0 + df1);
+
+        f0 = f1;
+        df0 = df1;
+    }
+}
+
+/**
+ * @brief      Evaluate the wave function at a single point
+ *
+ * @param[in]  x     x coordinate
+ * @param[in]  y     y coordinate
+ * @param[in]  z     z coordinate
+ *
+ * @return     Value of the wave function
+ */
+double GridEvaluator::value(double x, double y, double z) const {
+    const double r2 = x*x + y*y + z*z;
+    return this->radial_value(std::sqrt(r2)) * this->solid_harmonic(x, y, z, r2);
+}
+
+/**
+ * @brief      Evaluate the wave function on a row of points along x
+ *
+ * @param[in]  x0    x coordinate of the first point
+ * @param[in]  dx    spacing between the points
+ * @param[in]  y     y coordinate of the row
+ * @param[in]  z     z coordinate of the row
+ * @param[in]  nx    number of points
+ * @param      out   output values
+ */
+void GridEvaluator::evaluate_row(double x0, double dx, double y, double z, unsigned int nx, double* out) const {
+    const double yz2 = y*y + z*z;
+
+    #pragma omp simd
+    for(unsigned int i=0; i<nx; i++) {
+        const double x = x0 + (double)i * dx;
+        const double r2 = x*x + yz2;
+        out[i] = this->radial_value(std::sqrt(r2)) * this->solid_harmonic(x, y, z, r2);
+    }
+}
+
+/**
+ * @brief      Evaluate the gradient of the wave function at a single point
+ *
+ * @param[in]  x     x coordinate
+ * @param[in]  y     y coordinate
+ * @param[in]  z     z coordinate
+ *
+ * @return     Gradient of the wave function
+ */
+glm::dvec3 GridEvaluator::gradient(double x, double y, double z) const {
+    const double r2 = x*x + y*y + z*z;
+    const double r = std::sqrt(r2);
+
+    // azimuthal part (x + iy)^|m| and its derivative |m| (x + iy)^(|m|-1)
+    double re = 1.0, im = 0.0;
+    double dre = 0.0, dim = 0.0;
+    for(int k=0; k<this->am; k++) {
+        dre = re;
+        dim = im;
+        const double tmp = re * x - im * y;
+        im = re * y + im * x;
+        re = tmp;
+    }
+    dre *= (double)this->am;
+    dim *= (double)this->am;
+
+    double a = 1.0, dadx = 0.0, dady = 0.0;
+    if(this->m > 0) {
+        a = re;
+        dadx = dre;
+        dady = -dim;
+    } else if(this->m < 0) {
+        a = im;
+        dadx = dim;
+        dady = dre;
+    }
+
+    // polar polynomial in z and r^2 together with its partial derivatives
+    double p0 = 0.0, p1 = 1.0;
+    double dp0dz = 0.0, dp1dz = 0.0;
+    double dp0ds = 0.0, dp1ds = 0.0;
+    for(int j=0; j<this->l - this->am; j++) {
+        const double ca = this->recurrence_a[j];
+        const double cb = this->recurrence_b[j];
+        const double p2 = ca * z * p1 - cb * r2 * p0;
+        const double dp2dz = ca * p1 + ca * z * dp1dz - cb * r2 * dp0dz;
+        const double dp2ds = ca * z * dp1ds - cb * p0 - cb * r2 * dp0ds;
+        p0 = p1; p1 = p2;
+        dp0dz = dp1dz; dp1dz = dp2dz;
+        dp0ds = dp1ds; dp1ds = dp2ds;
+    }
+
+    const double sh = this->angular_prefactor * a * p1;
+    const glm::dvec3 dsh = this->angular_prefactor * glm::dvec3(
+        dadx * p1 + a * dp1ds * 2.0 * x,
+        dady * p1 + a * dp1ds * 2.0 * y,
+        a * (dp1dz + dp1ds * 2.0 * z));
+
+    // the radial derivative is undefined at the origin
+    const double f = this->radial_value(r);
+    const double dfr = r > 0.0 ? this->radial_derivative(r) / r : 0.0;
+
+    return dfr * sh * glm::dvec3(x, y, z) + f * dsh;
+}
+
+/**
+ * @brief      Get the parity of the wave function under reflection of one of
+ *             the Cartesian axes
+ *
+ * @param[in]  axis  0 for x, 1 for y and 2 for z
+ *
+ * @return     1 for an even and -1 for an odd wave function
+ */
+int GridEvaluator::get_parity(unsigned int axis) const {
+    switch(axis) {
+        case 0:
+            if(this->m == 0) {
+                return 1;
+            }
+            return ((this->am + (this->m < 0 ? 1 : 0)) % 2 == 0) ? 1 : -1;
+        case 1:
+            return this->m < 0 ? -1 : 1;
+        case 2:
+            return ((this->l - this->am) % 2 == 0) ? 1 : -1;
+        default:
+            throw std::logic_error("Invalid axis for parity.");
+    }
+}
+
+/**
+ * @brief      Radial part of the wave function divided by r^l
+ *
+ * @param[in]  wf    The wave function
+ * @param[in]  r     distance to the origin
+ * @param[out] df    derivative with respect to r
+ *
+ * @return     value at r
+ */
+double GridEvaluator::radial_function(const WaveFunction& wf, double r, double* df) {
+    const int n = wf.get_n();
+    const int l = wf.get_l();
+    const double rho = 2.0 * r / (double)n;
+    const double pre = wf.get_radial_prefactor() * std::pow(2.0 / (double)n, (double)l) * std::exp(-rho / 2.0);
+
+    // derivative of the associated Laguerre polynomial follows from
+    // d/dx L_k^a(x) = -L_{k-1}^{a+1}(x)
+    const double lag = laguerre_l(n - l - 1, 2 * l + 1, rho);
+    const double dlag = (n - l - 1) > 0 ? -laguerre_l(n - l - 2, 2 * l + 2, rho) : 0.0;
+
+    *df = pre * (-lag + 2.0 * dlag) / (double)n;
+    return pre * lag;
+}
@@ -0,0 +1,195 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+
+#ifndef _GRID_EVALUATOR_H
+#define _GRID_EVALUATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "wavefunction.h"
+
+/**
+ * @brief      Evaluates a wave function on rows of grid points
+ *
+ * The wave function is written as f(r) * S(x,y,z), where S is the solid
+ * harmonic r^l * Y_lm expressed as a polynomial in Cartesian coordinates
+ * and f(r) contains the remaining radial dependence, which is tabulated as
+ * a cubic Hermite spline. As such, no trigonometric functions are needed
+ * to evaluate a grid point and the wave function is also well-defined at
+ * the origin.
+ */
+class GridEvaluator {
+private:
+    int l;                              // angular quantum number
+    int am;                             // absolute value of the magnetic quantum number
+    int m;                              // magnetic quantum number
+
+    double angular_prefactor;           // normalization of the solid harmonic
+    std::vector<double> recurrence_a;   // coefficients of the z-term in the Legendre recurrence
+    std::vector<double> recurrence_b;   // coefficients of the r^2-term in the Legendre recurrence
+
+    double rmax;                        // upper limit of the radial spline
+    double inv_h;                       // inverse of the knot spacing
+    std::vector<double> spline;         // cubic polynomial coefficients per interval
+
+    static const unsigned int NR_INTERVALS = 4096;
+
+public:
+    /**
+     * @brief      Constructs a new instance.
+     *
+     * @param[in]  wf     The wave function
+     * @param[in]  _rmax  Largest distance to the origin to evaluate
+     */
+    GridEvaluator(const WaveFunction& wf, double _rmax);
+
+    /**
+     * @brief      Evaluate the wave function at a single point
+     *
+     * @param[in]  x     x coordinate
+     * @param[in]  y     y coordinate
+     * @param[in]  z     z coordinate
+     *
+     * @return     Value of the wave function
+     */
+    double value(double x, double y, double z) const;
+
+    /**
+     * @brief      Evaluate the wave function on a row of points along x
+     *
+     * @param[in]  x0    x coordinate of the first point
+     * @param[in]  dx    spacing between the points
+     * @param[in]  y     y coordinate of the row
+     * @param[in]  z     z coordinate of the row
+     * @param[in]  nx    number of points
+     * @param      out   output values
+     */
+    void evaluate_row(double x0, double dx, double y, double z, unsigned int nx, double* out) const;
+
+    /**
+     * @brief      Evaluate the gradient of the wave function at a single point
+     *
+     * @param[in]  x     x coordinate
+     * @param[in]  y     y coordinate
+     * @param[in]  z     z coordinate
+     *
+     * @return     Gradient of the wave function
+     */
+    glm::dvec3 gradient(double x, double y, double z) const;
+
+    /**
+     * @brief      Get the parity of the wave function under reflection of
+     *             one of the Cartesian axes
+     *
+     * The parity follows from the solid harmonic: the polynomial in z and r^2
+     * has parity (-1)^(l-|m|) in z, whereas Re[(x+iy)^|m|] is even in y and
+     * has parity (-1)^|m| in x, and Im[(x+iy)^|m|] is odd in y and has parity
+     * (-1)^(|m|+1) in x.
+     *
+     * @param[in]  axis  0 for x, 1 for y and 2 for z
+     *
+     * @return     1 for an even and -1 for an odd wave function
+     */
+    int get_parity(unsigned int axis) const;
+
+private:
+    /**
+     * @brief      Radial part of the wave function divided by r^l
+     *
+     * @param[in]  wf    The wave function
+     * @param[in]  r     distance to the origin
+     * @param[out] df    derivative with respect to r
+     *
+     * @return     value at r
+     */
+    static double radial_function(const WaveFunction& wf, double r, double* df);
+
+    /**
+     * @brief      Evaluate the radial spline
+     *
+     * @param[in]  r     distance to the origin
+     *
+     * @return     value at r
+     */
+    inline double radial_value(double r) const {
+        double t = std::min(r, this->rmax) * this->inv_h;
+        unsigned int idx = std::min((unsigned int)t, NR_INTERVALS - 1);
+        double u = t - (double)idx;
+        const double* c = &this->spline[idx * 4];
+        return c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+    }
+
+    /**
+     * @brief      Evaluate the derivative of the radial spline
+     *
+     * @param[in]  r     distance to the origin
+     *
+     * @return     derivative with respect to r at r
+     */
+    inline double radial_derivative(double r) const {
+        double t = std::min(r, this->rmax) * this->inv_h;
+        unsigned int idx = std::min((unsigned int)t, NR_INTERVALS - 1);
+        double u = t - (double)idx;
+        const double* c = &this->spline[idx * 4];
+        return (c[1] + u * (2.0 * c[2] + 3.0 * u * c[3])) * this->inv_h;
+    }
+
+    /**
+     * @brief      Evaluate the solid harmonic
+     *
+     * @param[in]  x     x coordinate
+     * @param[in]  y     y coordinate
+     * @param[in]  z     z coordinate
+     * @param[in]  r2    squared distance to the origin
+     *
+     * @return     value at (x,y,z)
+     */
+    inline double solid_harmonic(double x, double y, double z, double r2) const {
+        // azimuthal part as the real or imaginary part of (x + iy)^|m|
+        double re = 1.0;
+        double im = 0.0;
+        for(int k=0; k<this->am; k++) {
+            const double tmp = re * x - im * y;
+            im = re * y + im * x;
+            re = tmp;
+        }
+        const double azimuthal = this->m > 0 ? re : (this->m < 0 ? im : 1.0);
+
+        // polar part via the recurrence of the associated Legendre polynomials
+        double p0 = 0.0;
+        double p1 = 1.0;
+        for(int j=0; j<this->l - this->am; j++) {
+            const double p2 = this->recurrence_a[j] * z * p1 - this->recurrence_b[j] * r2 * p0;
+            p0 = p1;
+            p1 = p2;
+        }
+
+        return this->angular_prefactor * azimuthal * p1;
+    }
+};
+
+#endif // _GRID_EVALUATOR_H
@@ -0,0 +1,129 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#include "grid_storage.h"
+
+#include <algorithm>
+
+/**
+ * @brief      Construct zero-valued storage
+ *
+ * @param[in]  nx          Number of grid points along x
+ * @param[in]  ny          Number of grid points along y
+ * @param[in]  nz          Number of grid points along z
+ * @param[in]  _precision  Precision of the stored values
+ * @param[in]  _layout     Layout of the stored values
+ */
+GridStorage::GridStorage(unsigned int nx, unsigned int ny, unsigned int nz, Precision _precision, Layout _layout) :
+    dims{nx, ny, nz},
+    precision(_precision),
+    layout(_layout) {
+
+    size_t size = 1;
+    for(unsigned int a=0; a<3; a++) {
+        this->nr_tiles[a] = (this->dims[a] + TILE_MASK) >> TILE_BITS;
+
+        // the bricks along the upper boundaries are padded
+        size *= this->layout == Layout::BRICKED ? (size_t)this->nr_tiles[a] << TILE_BITS : (size_t)this->dims[a];
+    }
+
+    if(this->precision == Precision::FLOAT) {
+        this->values_float.resize(size, 0.0f);
+    } else {
+        this->values_double.resize(size, 0.0);
+    }
+}
+
+/**
+ * @brief      Copy a segment of a row of grid points along x
+ *
+ * @param[in]  j      Position along y
+ * @param[in]  k      Position along z
+ * @param[in]  start  First position along x
+ * @param[in]  stop   Last position along x (exclusive)
+ * @param      out    Values of the segment in single precision
+ */
+void GridStorage::read_row(unsigned int j, unsigned int k, unsigned int start, unsigned int stop, float* out) const {
+    if(this->precision == Precision::FLOAT) {
+        this->for_each_run(j, k, start, stop, [&](size_t idx, unsigned int x, unsigned int len) {
+            std::copy(this->values_float.begin() + idx, this->values_float.begin() + idx + len, out + (x - start));
+        });
+    } else {
+        this->for_each_run(j, k, start, stop, [&](size_t idx, unsigned int x, unsigned int len) {
+            for(unsigned int i=0; i<len; i++) {
+                out[x - start + i] = (float)this->values_double[idx + i];
+            }
+        });
+    }
+}
+
+/**
+ * @brief      Store a full row of grid points along x
+ *
+ * @param[in]  j      Position along y
+ * @param[in]  k      Position along z
+ * @param[in]  in     Values of the row
+ * @param[in]  scale  Factor applied to the values
+ */
+void GridStorage::write_row(unsigned int j, unsigned int k, const double* in, double scale) {
+    if(this->precision == Precision::FLOAT) {
+        this->for_each_run(j, k, 0, this->dims[0], [&](size_t idx, unsigned int x, unsigned int len) {
+            for(unsigned int i=0; i<len; i++) {
+                this->values_float[idx + i] = (float)(scale * in[x + i]);
+            }
+        });
+    } else {
+        this->for_each_run(j, k, 0, this->dims[0], [&](size_t idx, unsigned int x, unsigned int len) {
+            for(unsigned int i=0; i<len; i++) {
+                this->values_double[idx + i] = scale * in[x + i];
+            }
+        });
+    }
+}
+
+/**
+ * @brief      Visit the runs of a row segment that are contiguous in
+ *             storage
+ *
+ * @param[in]  j      Position along y
+ * @param[in]  k      Position along z
+ * @param[in]  start  First position along x
+ * @param[in]  stop   Last position along x (exclusive)
+ * @param[in]  func   Function receiving the storage index and the x
+ *                    position of the run start and the run length
+ */
+template<typename Func>
+void GridStorage::for_each_run(unsigned int j, unsigned int k, unsigned int start, unsigned int stop, Func func) const {
+    if(start >= stop) {
+        return;
+    }
+
+    if(this->layout == Layout::LINEAR) {
+        func(this->get_index(start, j, k), start, stop - start);
+        return;
+    }
+
+    for(unsigned int x = start; x < stop; ) {
+        const unsigned int len = std::min((x | TILE_MASK) + 1, stop) - x;
+        func(this->get_index(x, j, k), x, len);
+        x += len;
+    }
+}
@@ -0,0 +1,177 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef _GRID_STORAGE_H
+#define _GRID_STORAGE_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief      Storage of the values of a scalar field on a regular grid
+ *
+ * The values are stored either in double or in single precision, the latter
+ * halving the memory footprint. In the linear layout, x runs fastest followed
+ * by y and z. In the bricked layout, the grid is tiled into bricks of 8x8x8
+ * points, each stored contiguously, such that neighbouring grid points along
+ * any axis mostly share cache lines.
+ */
+class GridStorage {
+public:
+    enum class Precision {
+        DOUBLE,
+        FLOAT
+    };
+
+    enum class Layout {
+        LINEAR,
+        BRICKED
+    };
+
+private:
+    unsigned int dims[3];           // number of grid points along each axis
+    unsigned int nr_tiles[3];       // number of bricks along each axis in the bricked layout
+    Precision precision;
+    Layout layout;
+
+    std::vector<double> values_double;
+    std::vector<float> values_float;
+
+    static const unsigned int TILE_BITS = 3;                        // bricks span 2^3 points along each axis
+    static const unsigned int TILE_SIZE = 1 << TILE_BITS;
+    static const unsigned int TILE_MASK = TILE_SIZE - 1;
+
+public:
+    /**
+     * @brief      Construct zero-valued storage
+     *
+     * @param[in]  nx          Number of grid points along x
+     * @param[in]  ny          Number of grid points along y
+     * @param[in]  nz          Number of grid points along z
+     * @param[in]  _precision  Precision of the stored values
+     * @param[in]  _layout     Layout of the stored values
+     */
+    GridStorage(unsigned int nx, unsigned int ny, unsigned int nz,
+                Precision _precision = Precision::DOUBLE, Layout _layout = Layout::LINEAR);
+
+    inline Precision get_precision() const {
+        return this->precision;
+    }
+
+    inline Layout get_layout() const {
+        return this->layout;
+    }
+
+    inline unsigned int get_dimension(unsigned int axis) const {
+        return this->dims[axis];
+    }
+
+    /**
+     * @brief      Get the number of grid points
+     *
+     * @return     Number of grid points
+     */
+    inline size_t get_nr_points() const {
+        return (size_t)this->dims[0] * this->dims[1] * this->dims[2];
+    }
+
+    /**
+     * @brief      Get the number of bytes occupied by the values
+     *
+     * @return     Number of bytes
+     */
+    inline size_t get_memory_size() const {
+        return this->values_double.size() * sizeof(double) + this->values_float.size() * sizeof(float);
+    }
+
+    /**
+     * @brief      Get the position of a grid point in the stored values
+     *
+     * @param[in]  i     Position along x
+     * @param[in]  j     Position along y
+     * @param[in]  k     Position along z
+     *
+     * @return     Position in the stored values
+     */
+    inline size_t get_index(unsigned int i, unsigned int j, unsigned int k) const {
+        if(this->layout == Layout::LINEAR) {
+            return ((size_t)k * this->dims[1] + j) * this->dims[0] + i;
+        }
+
+        const size_t tile = ((size_t)(k >> TILE_BITS) * this->nr_tiles[1] + (j >> TILE_BITS)) * this->nr_tiles[0] + (i >> TILE_BITS);
+        return (tile << (3 * TILE_BITS)) |
+               ((k & TILE_MASK) << (2 * TILE_BITS)) |
+               ((j & TILE_MASK) << TILE_BITS) |
+               (i & TILE_MASK);
+    }
+
+    inline double get(unsigned int i, unsigned int j, unsigned int k) const {
+        const size_t idx = this->get_index(i, j, k);
+        return this->precision == Precision::FLOAT ? (double)this->values_float[idx] : this->values_double[idx];
+    }
+
+    inline void set(unsigned int i, unsigned int j, unsigned int k, double value) {
+        const size_t idx = this->get_index(i, j, k);
+        if(this->precision == Precision::FLOAT) {
+            this->values_float[idx] = (float)value;
+        } else {
+            this->values_double[idx] = value;
+        }
+    }
+
+    /**
+     * @brief      Copy a segment of a row of grid points along x
+     *
+     * @param[in]  j      Position along y
+     * @param[in]  k      Position along z
+     * @param[in]  start  First position along x
+     * @param[in]  stop   Last position along x (exclusive)
+     * @param      out    Values of the segment in single precision
+     */
+    void read_row(unsigned int j, unsigned int k, unsigned int start, unsigned int stop, float* out) const;
+
+    /**
+     * @brief      Store a full row of grid points along x
+     *
+     * @param[in]  j      Position along y
+     * @param[in]  k      Position along z
+     * @param[in]  in     Values of the row
+     * @param[in]  scale  Factor applied to the values
+     */
+    void write_row(unsigned int j, unsigned int k, const double* in, double scale = 1.0);
+
+private:
+    /**
+     * @brief      Visit the runs of a row segment that are contiguous in
+     *             storage
+     *
+     * @param[in]  j      Position along y
+     * @param[in]  k      Position along z
+     * @param[in]  start  First position along x
+     * @param[in]  stop   Last position along x (exclusive)
+     * @param[in]  func   Function receiving the storage index and the x
+     *                    position of the run start and the run length
+     */
+    template<typename Func>
+    void for_each_run(unsigned int j, unsigned int k, unsigned int start, unsigned int stop, Func func) const;
+};
+
+#endif //_GRID_STORAGE_H
@@ -23,57 +23,260 @@
 
 Integrator::Integrator(WaveFunction *_wf) {
     this->wf = _wf;
+    this->calculate_radial_coefficients();
 };
 
-double Integrator::integrate_radial_density(double a, double b, int steps, double* r) {
-    double s = 0; // sum
-    double h = (b-a)/steps;
+/**
+ * @brief      Integrate the radial density over all space
+ *
+ * In terms of rho = 2r/n, the radial density is exp(-rho) times a polynomial
+ * of degree 2n, which is integrated exactly by Gauss-Laguerre quadrature
+ * using n+1 points.
+ *
+ * @return     The integral, unity for a normalized wave function
+ */
+double Integrator::integrate_radial_density() const {
+    const double n = (double)this->wf->get_n();
+    std::vector<double> x, w;
+    gauss_laguerre(this->wf->get_n() + 1, x, w);
+
+    double s = 0;
+    for(unsigned int i=0; i<x.size(); i++) {
+        s += w[i] * std::exp(x[i]) * this->wf->radial_distribution_function(x[i] * n / 2.0);
+    }
+
+    return s * n / 2.0;
+}
+
+/**
+ * @brief      Find the isovalue of the surface enclosing a fraction of
+ *             the radial probability
+ *
+ * The radius is found by bisection on the cumulative radial probability,
+ * which increases monotonically with the radius.
+ *
+ * @param[in]  fraction  Fraction of the radial probability
+ * @param      r         Radius enclosing the fraction of the probability
+ *
+ * @return     The isovalue or -1 when no such radius could be found
+ */
+double Integrator::find_isosurface_volume(double fraction, double* r) const {
     *r = 0;
+    if(!(fraction > 0.0 && fraction < 1.0)) {
+        return -1;
+    }
 
-    for (int i = 0; i < steps; ++i) {
-        *r = a + h * (double)i;
+    // bracket the radius
+    double lo = 0.0;
+    double hi = (double)(this->wf->get_n() * this->wf->get_n());
+    unsigned int iter = 0;
+    while(this->radial_cumulative_probability(hi) < fraction) {
+        lo = hi;
+        hi *= 2.0;
+        if(++iter > 64) {
+            return -1;
+        }
+    }
 
-        s += (this->wf->radial_distribution_function(*r) +
-              4 * this->wf->radial_distribution_function(*r + h / 2.0) +
-              this->wf->radial_distribution_function(*r + h)) / 6.0;
+    // bisect the bracket
+    for(iter = 0; iter < 100 && (hi - lo) > 1e-12 * hi; iter++) {
+        const double mid = 0.5 * (lo + hi);
+        if(this->radial_cumulative_probability(mid) < fraction) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
     }
 
-    return h * s;
+    *r = 0.5 * (lo + hi);
+    return std::sqrt(this->wf->radial_distribution_function(*r) /
+                     (4.0 * M_PI * (*r) * (*r)));
 }
 
-double Integrator::find_isosurface_volume(double a, double b, int steps, double* r) {
+/**
+ * @brief      Integrate the polar and azimuthal density over the unit
+ *             sphere
+ *
+ * In terms of x = cos(theta), the polar density is a polynomial of degree 2l,
+ * which is integrated exactly by Gauss-Legendre quadrature using l+1 points.
+ *
+ * @return     The integral, unity for a normalized wave function
+ */
+double Integrator::integrate_spherical_harmonic() const {
+    std::vector<double> x, w;
+    gauss_legendre(this->wf->get_l() + 1, x, w);
+
     double s = 0;
-    double h = (b-a)/steps;
-    *r = 0;
+    for(unsigned int i=0; i<x.size(); i++) {
+        // remove the sin(theta) of the polar density, which is absorbed
+        // by the change of variables
+        s += w[i] * this->wf->polar_density(std::acos(x[i])) / std::sqrt(1.0 - x[i] * x[i]);
+    }
 
-    for (int i = 0; i < steps; ++i) {
-        *r = a + h * (double)i;
-
-        // use Simpson's rule
-        s += (this->wf->radial_distribution_function(*r) +
-              4 * this->wf->radial_distribution_function(*r + h / 2.0) +
-              this->wf->radial_distribution_function(*r + h)) / 6.0;
-        if(h * s >= 0.95) {
-            return std::sqrt(this->wf->radial_distribution_function(*r) /
-                       (4.0 * M_PI * (*r) * (*r)));
+    return s / 2.0; // due to azimuthal function
+}
+
+/**
+ * @brief      Probability to find the electron within a radius
+ *
+ * The integral of rho^d exp(-rho) from zero to x equals d! times the
+ * regularized lower incomplete gamma function, i.e.
+ * d! (1 - exp(-x) sum_{j<=d} x^j / j!).
+ *
+ * @param[in]  r     The radius
+ *
+ * @return     The cumulative radial probability
+ */
+double Integrator::radial_cumulative_probability(double r) const {
+    const double x = 2.0 * r / (double)this->wf->get_n();
+
+    double term = std::exp(-x);     // exp(-x) x^d / d!
+    double partial = term;          // exp(-x) sum_{j<=d} x^j / j!
+    double s = 0;
+    for(unsigned int d=0; d<this->radial_coefficients.size(); d++) {
+        if(d > 0) {
+            term *= x / (double)d;
+            partial += term;
         }
+        s += this->radial_coefficients[d] * (1.0 - partial);
     }
 
-    return -1;
+    return s / this->radial_total;
 }
 
-double Integrator::integrate_spherical_harmonic(double a, double b, int steps) {
-    double s = 0;
-    double h = (b-a)/steps;
-    double r = 0;
-    for (int i = 0; i < steps; ++i) {
-        r = a + h * (double)i;
+/**
+ * @brief      Calculate the coefficients of the radial density
+ *
+ * The radial density is proportional to rho^(2l+2) L(rho)^2 exp(-rho), with L
+ * the associated Laguerre polynomial of degree n-l-1 and order 2l+1.
+ */
+void Integrator::calculate_radial_coefficients() {
+    const int n = this->wf->get_n();
+    const int l = this->wf->get_l();
+    const int k = n - l - 1;
+    const int alpha = 2 * l + 1;
+
+    // coefficients of the associated Laguerre polynomial,
+    // (-1)^i binom(k+alpha, k-i) / i!
+    std::vector<double> a(k+1);
+    a[0] = 1.0;
+    for(int i=0; i<k; i++) {
+        a[0] *= (double)(k + alpha - i) / (double)(k - i);
+    }
+    for(int i=0; i<k; i++) {
+        a[i+1] = -a[i] * (double)(k - i) / ((double)(alpha + i + 1) * (double)(i + 1));
+    }
+
+    // square the polynomial and multiply by rho^(2l+2)
+    this->radial_coefficients.assign(2 * n + 1, 0.0);
+    for(int i=0; i<=k; i++) {
+        for(int j=0; j<=k; j++) {
+            this->radial_coefficients[2 * l + 2 + i + j] += a[i] * a[j];
+        }
+    }
+
+    // multiply by d!, the integral of rho^d exp(-rho)
+    double fac = 1.0;
+    this->radial_total = 0.0;
+    for(unsigned int d=0; d<this->radial_coefficients.size(); d++) {
+        if(d > 0) {
+            fac *= (double)d;
+        }
+        this->radial_coefficients[d] *= fac;
+        this->radial_total += this->radial_coefficients[d];
+    }
+}
+
+/**
+ * @brief      Abscissas and weights of Gauss-Laguerre quadrature
+ *
+ * The roots of the Laguerre polynomial are found by Newton's method, see
+ * Numerical Recipes, section 4.5.
+ *
+ * @param[in]  n     Number of points
+ * @param      x     Abscissas
+ * @param      w     Weights
+ */
+void Integrator::gauss_laguerre(unsigned int n, std::vector<double>& x, std::vector<double>& w) {
+    x.resize(n);
+    w.resize(n);
+
+    double z = 0.0;
+    for(unsigned int i=0; i<n; i++) {
+        // initial guesses of the roots
+        if(i == 0) {
+            z = 3.0 / (1.0 + 2.4 * (double)n);
+        } else if(i == 1) {
+            z += 15.0 / (1.0 + 2.5 * (double)n);
+        } else {
+            const double ai = (double)(i - 1);
+            z += (1.0 + 2.55 * ai) / (1.9 * ai) * (z - x[i-2]);
+        }
+
+        double p1 = 0.0, p2 = 0.0, pp = 0.0;
+        for(unsigned int iter=0; iter<100; iter++) {
+            p1 = 1.0;
+            p2 = 0.0;
+            for(unsigned int j=0; j<n; j++) {
+                const double p3 = p2;
+                p2 = p1;
+                p1 = ((double)(2 * j + 1) - z) * p2 / (double)(j + 1) - (double)j * p3 / (double)(j + 1);
+            }
+            pp = (double)n * (p1 - p2) / z;
+
+            const double z1 = z;
+            z = z1 - p1 / pp;
+            if(std::abs(z - z1) <= 1e-15 * std::abs(z)) {
+                break;
+            }
+        }
+
+        x[i] = z;
+        w[i] = -1.0 / (pp * (double)n * p2);
+    }
+}
+
+/**
+ * @brief      Abscissas and weights of Gauss-Legendre quadrature on [-1,1]
+ *
+ * The roots of the Legendre polynomial are found by Newton's method, see
+ * Numerical Recipes, section 4.5.
+ *
+ * @param[in]  n     Number of points
+ * @param      x     Abscissas
+ * @param      w     Weights
+ */
+void Integrator::gauss_legendre(unsigned int n, std::vector<double>& x, std::vector<double>& w) {
+    x.resize(n);
+    w.resize(n);
+
+    // the roots are symmetric, hence only half of them is determined
+    for(unsigned int i=0; i<(n+1)/2; i++) {
+        double z = std::cos(M_PI * ((double)i + 0.75) / ((double)n + 0.5));
+
+        double pp = 0.0;
+        for(unsigned int iter=0; iter<100; iter++) {
+            double p1 = 1.0;
+            double p2 = 0.0;
+            for(unsigned int j=0; j<n; j++) {
+                const double p3 = p2;
+                p2 = p1;
+                p1 = ((double)(2 * j + 1) * z * p2 - (double)j * p3) / (double)(j + 1);
+            }
+            pp = (double)n * (z * p1 - p2) / (z * z - 1.0);
+
+            const double z1 = z;
+            z = z1 - p1 / pp;
+            if(std::abs(z - z1) <= 1e-15) {
+                break;
+            }
+        }
 
-        s += (this->wf->polar_density(r) +
-              4 * this->wf->polar_density(r + h / 2.0) +
-              this->wf->polar_density(r + h)) / 6.0;
+        x[i] = -z;
+        x[n-1-i] = z;
+        w[i] = 2.0 / ((1.0 - z * z) * pp * pp);
+        w[n-1-i] = w[i];
     }
-    return h * s / 2.0; // due to azimuthal function
 }
 
 double Integrator::integrate_x2(double a, double b, int steps) {
@@ -27,20 +27,73 @@
 #endif
 
 #include <cmath>
+#include <vector>
 
 #include "wavefunction.h"
 
+/**
+ * @brief      Integrates the radial and angular parts of a wave function
+ *
+ * The radial and angular densities are polynomials times an exponential
+ * weight, which are integrated exactly by Gauss-Laguerre and Gauss-Legendre
+ * quadrature respectively. The cumulative radial probability is evaluated in
+ * closed form from the coefficients of the radial polynomial.
+ */
 class Integrator{
 private:
-    //unsigned int steps;
     WaveFunction *wf;
 
+    // coefficients of the radial density in rho = 2r/n, multiplied by the
+    // factorial of the power, such that their sum is the total integral
+    std::vector<double> radial_coefficients;
+    double radial_total;
+
 public:
     Integrator(WaveFunction *_wf);
-    double integrate_radial_density(double a, double b, int steps, double* r);
-    double find_isosurface_volume(double a, double b, int steps, double* r);
-    double integrate_spherical_harmonic(double a, double b, int steps);
+
+    /**
+     * @brief      Integrate the radial density over all space
+     *
+     * @return     The integral, unity for a normalized wave function
+     */
+    double integrate_radial_density() const;
+
+    /**
+     * @brief      Find the isovalue of the surface enclosing a fraction of
+     *             the radial probability
+     *
+     * @param[in]  fraction  Fraction of the radial probability
+     * @param      r         Radius enclosing the fraction of the probability
+     *
+     * @return     The isovalue or -1 when no such radius could be found
+     */
+    double find_isosurface_volume(double fraction, double* r) const;
+
+    /**
+     * @brief      Integrate the polar and azimuthal density over the unit
+     *             sphere
+     *
+     * @return     The integral, unity for a normalized wave function
+     */
+    double integrate_spherical_harmonic() const;
+
+    /**
+     * @brief      Probability to find the electron within a radius
+     *
+     * @param[in]  r     The radius
+     *
+     * @return     The cumulative radial probability
+     */
+    double radial_cumulative_probability(double r) const;
+
     double integrate_x2(double a, double b, int steps); //testroutine
+
+private:
+    void calculate_radial_coefficients();
+
+    static void gauss_laguerre(unsigned int n, std::vector<double>& x, std::vector<double>& w);
+
+    static void gauss_legendre(unsigned int n, std::vector<double>& x, std::vector<double>& w);
 };
 
 #endif
@@ -21,114 +21,13 @@
 
 #include "isosurface.h"
 
-/**************
- *    CUBE    *
- **************/
-
-/*
- *          z
- *          |
- *          4------5
- *         /|     /|
- *        7-|----6 |
- *        | 0----|-1--- y (j)
- *        |/     |/
- *        3 ---- 2
- *       /
- *      x (i)
- *
- */
+#include <array>
 
-Cube::Cube(unsigned int _i, unsigned int _j, unsigned int _k, const ScalarField &_vp) {
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-    this->i = _i;
-    this->j = _j;
-    this->k = _k;
-    this->cubidx = 0;
-
-    values[0] = _vp.get_value(_i, _j, _k);
-    values[1] = _vp.get_value(_i, _j+1, _k);
-    values[2] = _vp.get_value(_i+1, _j+1, _k);
-    values[3] = _vp.get_value(_i+1, _j, _k);
-
-    values[4] = _vp.get_value(_i, _j, _k+1);
-    values[5] = _vp.get_value(_i, _j+1, _k+1);
-    values[6] = _vp.get_value(_i+1, _j+1, _k+1);
-    values[7] = _vp.get_value(_i+1, _j, _k+1);
-}
-
-void Cube::set_cube_index(float _isovalue) {
-    if (this->values[0] < _isovalue) this->cubidx |= (1 << 0);
-    if (this->values[1] < _isovalue) this->cubidx |= (1 << 1);
-    if (this->values[2] < _isovalue) this->cubidx |= (1 << 2);
-    if (this->values[3] < _isovalue) this->cubidx |= (1 << 3);
-    if (this->values[4] < _isovalue) this->cubidx |= (1 << 4);
-    if (this->values[5] < _isovalue) this->cubidx |= (1 << 5);
-    if (this->values[6] < _isovalue) this->cubidx |= (1 << 6);
-    if (this->values[7] < _isovalue) this->cubidx |= (1 << 7);
-}
-
-unsigned int Cube::get_cube_index() const {
-    return this->cubidx;
-}
-
-float Cube::get_value_from_vertex(unsigned int _p) const {
-    return this->values[_p];
-}
-
-glm::vec3 Cube::get_position_from_vertex(unsigned int _p) const {
-    glm::vec3 c;
-    if(_p == 0) {
-        c[0] = (float)this->i;
-        c[1] = (float)this->j;
-        c[2] = (float)this->k;
-    } else if(_p == 1) {
-        c[0] = (float)this->i;
-        c[1] = (float)this->j+1;
-        c[2] = (float)this->k;
-    } else if(_p == 2) {
-        c[0] = (float)this->i+1;
-        c[1] = (float)this->j+1;
-        c[2] = (float)this->k;
-    } else if(_p == 3) {
-        c[0] = (float)this->i+1;
-        c[1] = (float)this->j;
-        c[2] = (float)this->k;
-    } else if(_p == 4) {
-        c[0] = (float)this->i;
-        c[1] = (float)this->j;
-        c[2] = (float)this->k+1;
-    } else if(_p == 5) {
-        c[0] = (float)this->i;
-        c[1] = (float)this->j+1;
-        c[2] = (float)this->k+1;
-    } else if(_p == 6) {
-        c[0] = (float)this->i+1;
-        c[1] = (float)this->j+1;
-        c[2] = (float)this->k+1;
-    } else if(_p == 7) {
-        c[0] = (float)this->i+1;
-        c[1] = (float)this->j;
-        c[2] = (float)this->k+1;
-    } else {
-        c[0] = 0;
-        c[1] = 0;
-        c[2] = 0;
-    }
-
-    return c;
-}
-
-/*********************
- *    TETRAHEDRON    *
- *********************/
-
-Tetrahedron::Tetrahedron(unsigned int _i, unsigned int _j, unsigned int _k,
-    const ScalarField &_vp, unsigned int _pos) {
-    this->i = _i;
-    this->j = _j;
-    this->k = _k;
-    this->tetidx = 0;
+namespace {
 
 /*
  *          z
@@ -144,145 +43,133 @@ Tetrahedron::Tetrahedron(unsigned int _i, unsigned int _j, unsigned int _k,
  *
  */
 
-    switch(_pos) {
-        case 0: // 0 2 3 7
-            values[0] = _vp.get_value(_i    , _j    , _k);
-            values[1] = _vp.get_value(_i+1, _j+1, _k);
-            values[2] = _vp.get_value(_i+1, _j    , _k);
-            values[3] = _vp.get_value(_i+1, _j    , _k+1);
-            pos[0][0] = _i     ; pos[0][1] = _j     ; pos[0][2] = _k     ;
-            pos[1][0] = _i+1   ; pos[1][1] = _j+1 ; pos[1][2] = _k     ;
-            pos[2][0] = _i+1   ; pos[2][1] = _j     ; pos[2][2] = _k     ;
-            pos[3][0] = _i+1   ; pos[3][1] = _j     ; pos[3][2] = _k+1 ;
-        break;
-        case 1: // 0 2 6 7
-            values[0] = _vp.get_value(_i,     _j,     _k);
-            values[1] = _vp.get_value(_i+1, _j+1, _k);
-            values[2] = _vp.get_value(_i+1, _j+1, _k+1);
-            values[3] = _vp.get_value(_i+1, _j ,    _k+1);
-            pos[0][0] = _i     ; pos[0][1] = _j     ; pos[0][2] = _k     ;
-            pos[1][0] = _i+1   ; pos[1][1] = _j+1 ; pos[1][2] = _k     ;
-            pos[2][0] = _i+1   ; pos[2][1] = _j+1 ; pos[2][2] = _k+1 ;
-            pos[3][0] = _i+1   ; pos[3][1] = _j     ; pos[3][2] = _k+1 ;
-        break;
-        case 2: // 0 4 6 7
-            values[0] = _vp.get_value(_i, _j, _k);
-            values[1] = _vp.get_value(_i, _j, _k+1);
-            values[2] = _vp.get_value(_i+1, _j+1, _k+1);
-            values[3] = _vp.get_value(_i+1, _j ,    _k+1);
-            pos[0][0] = _i     ; pos[0][1] = _j     ; pos[0][2] = _k     ;
-            pos[1][0] = _i     ; pos[1][1] = _j     ; pos[1][2] = _k+1 ;
-            pos[2][0] = _i+1   ; pos[2][1] = _j+1 ; pos[2][2] = _k+1 ;
-            pos[3][0] = _i+1   ; pos[3][1] = _j     ; pos[3][2] = _k+1 ;
-        break;
-        case 3: // 0 6 1 2
-            values[0] = _vp.get_value(_i, _j, _k);
-            values[1] = _vp.get_value(_i+1, _j+1, _k+1);
-            values[2] = _vp.get_value(_i, _j+1, _k);
-            values[3] = _vp.get_value(_i+1, _j+1, _k);
-            pos[0][0] = _i     ; pos[0][1] = _j     ; pos[0][2] = _k     ;
-            pos[1][0] = _i+1   ; pos[1][1] = _j+1 ; pos[1][2] = _k+1 ;
-            pos[2][0] = _i     ; pos[2][1] = _j+1 ; pos[2][2] = _k     ;
-            pos[3][0] = _i+1   ; pos[3][1] = _j+1 ; pos[3][2] = _k     ;
-        break;
-        case 4: // 0 6 1 4
-            values[0] = _vp.get_value(_i, _j, _k);
-            values[1] = _vp.get_value(_i+1, _j+1, _k+1);
-            values[2] = _vp.get_value(_i, _j+1, _k);
-            values[3] = _vp.get_value(_i, _j, _k+1);
-            pos[0][0] = _i     ; pos[0][1] = _j     ; pos[0][2] = _k     ;
-            pos[1][0] = _i+1   ; pos[1][1] = _j+1 ; pos[1][2] = _k+1 ;
-            pos[2][0] = _i     ; pos[2][1] = _j+1 ; pos[2][2] = _k     ;
-            pos[3][0] = _i     ; pos[3][1] = _j     ; pos[3][2] = _k+1 ;
-        break;
-        case 5: // 5 6 1 4
-            values[0] = _vp.get_value(_i, _j+1, _k+1);
-            values[1] = _vp.get_value(_i+1, _j+1, _k+1);
-            values[2] = _vp.get_value(_i, _j+1, _k);
-            values[3] = _vp.get_value(_i, _j, _k+1);
-            pos[0][0] = _i     ; pos[0][1] = _j+1 ; pos[0][2] = _k+1 ;
-            pos[1][0] = _i+1   ; pos[1][1] = _j+1 ; pos[1][2] = _k+1 ;
-            pos[2][0] = _i     ; pos[2][1] = _j+1 ; pos[2][2] = _k     ;
-            pos[3][0] = _i     ; pos[3][1] = _j     ; pos[3][2] = _k+1 ;
-        break;
-        default:
-            exit(-1);
-    }
-}
+// grid offsets (x,y,z) of the cube vertices
+const unsigned int cube_vertices[8][3] = {
+    {0,0,0}, {0,1,0}, {1,1,0}, {1,0,0},
+    {0,0,1}, {0,1,1}, {1,1,1}, {1,0,1}
+};
 
-void Tetrahedron::set_tetrahedron_index(float _isovalue) {
-    if (this->values[0] < _isovalue) this->tetidx |= (1 << 0);
-    if (this->values[1] < _isovalue) this->tetidx |= (1 << 1);
-    if (this->values[2] < _isovalue) this->tetidx |= (1 << 2);
-    if (this->values[3] < _isovalue) this->tetidx |= (1 << 3);
-}
+// pairs of cube vertices spanning the twelve cube edges
+const unsigned int cube_edges[12][2] = {
+    {0,1}, {1,2}, {2,3}, {3,0},
+    {4,5}, {5,6}, {6,7}, {7,4},
+    {0,4}, {1,5}, {2,6}, {3,7}
+};
 
-unsigned int Tetrahedron::get_tetrahedron_index() const {
-    return this->tetidx;
-}
+/*
+ *               + 0
+ *              /|\
+ *             / | \
+ *            /  |  \
+ *           /   |   \
+ *          /    |    \
+ *         /     |     \
+ *        +-------------+ 1
+ *       3 \     |     /
+ *          \    |    /
+ *           \   |   /
+ *            \  |  /
+ *             \ | /
+ *              \|/
+ *               + 2
+ */
 
-float Tetrahedron::get_value_from_vertex(unsigned int _p) const {
-    return this->values[_p];
-}
+// decomposition of the cube into six tetrahedra
+const unsigned int cube_tetrahedra[6][4] = {
+    {0, 2, 3, 7},
+    {0, 2, 6, 7},
+    {0, 4, 6, 7},
+    {0, 6, 1, 2},
+    {0, 6, 1, 4},
+    {5, 6, 1, 4}
+};
+
+// directions of the edges lying in a plane of constant z and of the edges
+// connecting two consecutive planes; besides the grid axes these contain the
+// face and body diagonals of the tetrahedral decomposition
+const unsigned int NR_PLANE_EDGES = 3;
+const unsigned int NR_LAYER_EDGES = 4;
+
+const int plane_directions[NR_PLANE_EDGES][3] = {
+    {1, 0, 0},
+    {0, 1, 0},
+    {1, 1, 0}
+};
+
+const int layer_directions[NR_LAYER_EDGES][3] = {
+    {0, 0, 1},
+    {1, 0, 1},
+    {0,-1, 1},
+    {1, 1, 1}
+};
+
+// vertex index of an edge that has not been intersected yet
+const uint32_t UNSET_VERTEX = 0xFFFFFFFF;
+
+// flags a vertex in the bottom plane of a slab, owned by the previous slab
+const uint32_t PREVIOUS_SLAB = 0x80000000;
 
-const glm::vec3& Tetrahedron::get_position_from_vertex(unsigned int _p) const {
-    return pos[_p];
-}
-
-/**************
- *  TRIANGLE  *
- **************/
+/**
+ * @brief Location of an edge between two cube vertices in the edge caches
+ */
+struct EdgeSlot {
+    unsigned int cache;     // 0: lower plane, 1: upper plane, 2: between the planes
+    unsigned int dx, dy;    // offset of the starting grid point within the cell
+    unsigned int dir;       // edge direction
+    unsigned int v1, v2;    // cube vertices ordered from start to end point
+};
 
-Triangle::Triangle(const glm::vec3 &_p1, const glm::vec3 &_p2, const glm::vec3 &_p3) {
-    this->p1 = _p1;
-    this->p2 = _p2;
-    this->p3 = _p3;
-}
+/**
+ * @brief      Build the lookup table of the edges between all pairs of cube
+ *             vertices
+ *
+ * Every edge is attributed to the grid point having the lowest z, y and x
+ * coordinate such that neighbouring cells refer to the same edge.
+ *
+ * @return     Edge slots indexed by the two cube vertices
+ */
+std::array<std::array<EdgeSlot, 8>, 8> build_edge_slots() {
+    std::array<std::array<EdgeSlot, 8>, 8> slots{};
+
+    for(unsigned int v1=0; v1<8; v1++) {
+        for(unsigned int v2=0; v2<8; v2++) {
+            EdgeSlot& slot = slots[v1][v2];
+            slot.v1 = v1;
+            slot.v2 = v2;
+
+            int d[3];
+            for(unsigned int i=0; i<3; i++) {
+                d[i] = (int)cube_vertices[v2][i] - (int)cube_vertices[v1][i];
+            }
 
-void Triangle::transform_to_real(const ScalarField &_vp) {
-    p1 = _vp.grid_to_realspace(p1[0], p1[1], p1[2]);
-    p2 = _vp.grid_to_realspace(p2[0], p2[1], p2[2]);
-    p3 = _vp.grid_to_realspace(p3[0], p3[1], p3[2]);
-}
+            if(d[2] < 0 || (d[2] == 0 && (d[1] < 0 || (d[1] == 0 && d[0] < 0)))) {
+                std::swap(slot.v1, slot.v2);
+                for(unsigned int i=0; i<3; i++) {
+                    d[i] = -d[i];
+                }
+            }
 
-float Triangle::get_x(unsigned int i) const {
-    switch(i) {
-        case 0:
-            return p1[0];
-        case 1:
-            return p2[0];
-        case 2:
-            return p3[0];
-        default:
-            return p1[0];
+            slot.dx = cube_vertices[slot.v1][0];
+            slot.dy = cube_vertices[slot.v1][1];
+
+            const unsigned int nr_dirs = d[2] == 0 ? NR_PLANE_EDGES : NR_LAYER_EDGES;
+            const int (*dirs)[3] = d[2] == 0 ? plane_directions : layer_directions;
+            slot.cache = d[2] == 0 ? cube_vertices[slot.v1][2] : 2;
+            slot.dir = 0;
+            while(slot.dir < nr_dirs && !(dirs[slot.dir][0] == d[0] &&
+                                          dirs[slot.dir][1] == d[1] &&
+                                          dirs[slot.dir][2] == d[2])) {
+                slot.dir++;
+            }
+        }
     }
-}
 
-float Triangle::get_y(unsigned int i) const {
-    switch(i) {
-        case 0:
-            return p1[1];
-        case 1:
-            return p2[1];
-        case 2:
-            return p3[1];
-        default:
-            return p1[1];
-    }
+    return slots;
 }
 
-float Triangle::get_z(unsigned int i) const {
-    switch(i) {
-        case 0:
-            return p1[2];
-        case 1:
-            return p2[2];
-        case 2:
-            return p3[2];
-        default:
-            return p1[2];
-    }
-}
+const std::array<std::array<EdgeSlot, 8>, 8> edge_slots = build_edge_slots();
+
+} // namespace
 
 /**************
  * ISOSURFACE *
@@ -293,8 +180,7 @@ float Triangle::get_z(unsigned int i) const {
  *
  * @param      _sf   pointer to ScalarField object
  */
-IsoSurface::IsoSurface(ScalarField* _vp) {
-    this->isovalue = 0;
+IsoSurface::IsoSurface(const ScalarField* _vp) {
     this->vp_ptr = _vp;
     this->vp_ptr->copy_grid_dimensions(this->grid_dimensions);
 }
@@ -305,14 +191,17 @@ IsoSurface::IsoSurface(ScalarField* _vp) {
  * @param[in]  _isovalue  The isovalue
  */
 void IsoSurface::marching_cubes(float _isovalue) {
-    this->isovalue = _isovalue;
-    this->sample_grid_with_cubes(_isovalue);
-    this->construct_triangles_from_cubes(_isovalue);
+    this->march({_isovalue}, false);
+}
 
-    #pragma omp parallel for
-    for(unsigned int i=0; i < this->triangles.size(); i++) {
-        triangles[i].transform_to_real(*this->vp_ptr);
-    }
+/**
+ * @brief      generate isosurfaces for several isovalues using the marching
+ *             cubes algorithm in a single pass over the grid
+ *
+ * @param[in]  _isovalues  The isovalues
+ */
+void IsoSurface::marching_cubes(const std::vector<float>& _isovalues) {
+    this->march(_isovalues, false);
 }
 
 /**
@@ -321,243 +210,406 @@ void IsoSurface::marching_cubes(float _isovalue) {
  * @param[in]  _isovalue  The isovalue
  */
 void IsoSurface::marching_tetrahedra(float _isovalue) {
-    this->isovalue = _isovalue;
-    this->sample_grid_with_tetrahedra(_isovalue);
-    this->construct_triangles_from_tetrahedra(_isovalue);
-    for(std::vector<Triangle>::iterator it = triangles.begin();
-        it != triangles.end(); ++it) {
-        it->transform_to_real(*this->vp_ptr);
-    }
+    this->march({_isovalue}, true);
 }
 
 /**
- * @brief      Gets the triangles pointer.
+ * @brief      generate isosurfaces for several isovalues using the marching
+ *             tetrahedra algorithm in a single pass over the grid
  *
- * @return     The triangles pointer.
+ * @param[in]  _isovalues  The isovalues
  */
-const std::vector<Triangle>* IsoSurface::get_triangles_ptr() const {
-    return &this->triangles;
+void IsoSurface::marching_tetrahedra(const std::vector<float>& _isovalues) {
+    this->march(_isovalues, true);
 }
 
-void IsoSurface::sample_grid_with_cubes(float _isovalue) {
-    std::mutex push_back_mutex;
-
-    #pragma omp parallel for schedule(dynamic)
-    for(unsigned int i = 0; i < this->grid_dimensions[2] - 1; i++) {
-        for(unsigned int j = 0; j < this->grid_dimensions[1] - 1; j++) {
-            for(unsigned int k = 0; k < this->grid_dimensions[0] - 1; k++) {
-                Cube cub(k, j, i, *this->vp_ptr);
-                cub.set_cube_index(_isovalue);
-                if(!(cub.get_cube_index() == (unsigned int)0 ||
-                    cub.get_cube_index() == (unsigned int)255)) {
-                    push_back_mutex.lock();
-                    this->cube_table.push_back(cub);
-                    push_back_mutex.unlock();
-                }
-            }
-        }
-    }
+/**
+ * @brief      Set the number of threads used for the isosurface construction
+ *
+ * @param[in]  _nr_threads  Number of threads; 0 uses all available threads
+ */
+void IsoSurface::set_nr_threads(unsigned int _nr_threads) {
+    this->nr_threads = _nr_threads;
 }
 
-void IsoSurface::sample_grid_with_tetrahedra(float _isovalue) {
-    for(unsigned int i = 0; i < this->grid_dimensions[2] - 1; i++) {
-        for(unsigned int j = 0; j < this->grid_dimensions[1] - 1; j++) {
-            for(unsigned int k = 0; k < this->grid_dimensions[0] - 1; k++) {
-                for(unsigned int l=0; l<6; l++) {
-                    Tetrahedron tet(k, j, i, *this->vp_ptr, l);
-                    tet.set_tetrahedron_index(_isovalue);
-                    if(!(tet.get_tetrahedron_index() == (unsigned int)0 ||
-                             tet.get_tetrahedron_index() == (unsigned int)15)) {
-                        this->tetrahedra_table.push_back(tet);
-                    }
+/**
+ * @brief      Get the number of threads used for the isosurface construction
+ *
+ * @return     Number of threads
+ */
+int IsoSurface::get_nr_threads() const {
+#ifdef _OPENMP
+    return this->nr_threads > 0 ? (int)this->nr_threads : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief      Construct the isosurfaces using either cubes or tetrahedra
+ *
+ * The grid is divided into slabs along z which are swept in parallel. Every
+ * slab classifies and triangulates its cells for all isovalues in a single
+ * pass and writes the real-space vertices directly to its output. The
+ * vertices on the bottom plane of a slab belong to the previous slab and are
+ * resolved once all slabs are done, such that every intersected grid edge
+ * yields exactly one vertex. The result does not depend on the number of
+ * threads. When the scalar field provides a min/max brick hierarchy, only the
+ * bricks whose value range straddles an isovalue are visited.
+ *
+ * @param[in]  _isovalues   The isovalues
+ * @param[in]  tetrahedra   Whether to use marching tetrahedra
+ */
+void IsoSurface::march(const std::vector<float>& _isovalues, bool tetrahedra) {
+    const size_t nr_surfaces = _isovalues.size();
+    this->isovalues = _isovalues;
+    this->vertices.assign(nr_surfaces, std::vector<glm::vec3>());
+    this->indices.assign(nr_surfaces, std::vector<unsigned int>());
+
+    if(nr_surfaces == 0 || this->grid_dimensions[0] < 2 ||
+       this->grid_dimensions[1] < 2 || this->grid_dimensions[2] < 2) {
+        return;
+    }
+
+    // use several slabs per thread for load balancing; the isosurface is
+    // typically concentrated in the center of the grid
+    const int nr_threads = this->get_nr_threads();
+    const unsigned int nr_layers = this->grid_dimensions[2] - 1;
+    const unsigned int nr_slabs = std::min(nr_layers, 4 * (unsigned int)nr_threads);
+
+    std::vector<std::vector<Slab>> slabs(nr_slabs, std::vector<Slab>(nr_surfaces));
+
+    std::vector<uint8_t> active_bricks;
+    if(this->vp_ptr->get_bricks()) {
+        this->vp_ptr->get_bricks()->find_active_bricks(_isovalues, active_bricks);
+    }
+
+    #pragma omp parallel for schedule(dynamic) num_threads(nr_threads)
+    for(int s=0; s<(int)nr_slabs; s++) {
+        this->march_slab(s * nr_layers / nr_slabs, (s + 1) * nr_layers / nr_slabs,
+                         _isovalues, tetrahedra, active_bricks, slabs[s]);
+    }
+
+    for(size_t l=0; l<nr_surfaces; l++) {
+        // determine the offsets of each slab in the vertex and index lists
+        std::vector<size_t> vertex_offsets(nr_slabs + 1, 0);
+        std::vector<size_t> index_offsets(nr_slabs + 1, 0);
+        for(unsigned int s=0; s<nr_slabs; s++) {
+            vertex_offsets[s+1] = vertex_offsets[s] + slabs[s][l].vertices.size();
+            index_offsets[s+1] = index_offsets[s] + slabs[s][l].indices.size();
+        }
+
+        auto& surface_vertices = this->vertices[l];
+        auto& surface_indices = this->indices[l];
+        surface_vertices.resize(vertex_offsets[nr_slabs]);
+        surface_indices.resize(index_offsets[nr_slabs]);
+
+        #pragma omp parallel for schedule(dynamic) num_threads(nr_threads)
+        for(int s=0; s<(int)nr_slabs; s++) {
+            const Slab& slab = slabs[s][l];
+            std::copy(slab.vertices.begin(), slab.vertices.end(),
+                      surface_vertices.begin() + vertex_offsets[s]);
+
+            for(size_t i=0; i<slab.indices.size(); i++) {
+                const uint32_t idx = slab.indices[i];
+                if(idx & PREVIOUS_SLAB) {
+                    surface_indices[index_offsets[s] + i] = vertex_offsets[s-1] + slabs[s-1][l].top_plane[idx & ~PREVIOUS_SLAB];
+                } else {
+                    surface_indices[index_offsets[s] + i] = vertex_offsets[s] + idx;
                 }
             }
         }
+
+        std::cout << "Identified " << surface_indices.size() / 3 << " faces and "
+                  << surface_vertices.size() << " vertices for isovalue "
+                  << _isovalues[l] << "." << std::endl;
     }
 }
 
-void IsoSurface::construct_triangles_from_cubes(float _isovalue) {
-    std::mutex push_back_mutex;
-
-    #pragma omp parallel for schedule(dynamic)
-    for(unsigned int i=0; i < cube_table.size(); i++) {
-        uint8_t cubeindex = cube_table[i].get_cube_index();
-        glm::vec3 vertices_list[12];
-
-        /* Find the vertices where the surface intersects the cube, perform
-        an interpolation of 2 (glm::vec3) coordinates and 2 values and the isovalue,
-        return one (glm::vec3) coordinate as the result */
-        if (edge_table[cubeindex] & (1 << 0))
-            vertices_list[0] =
-                this->interpolate_from_cubes(cube_table[i], 0, 1, _isovalue);
-        if (edge_table[cubeindex] & (1 << 1))
-            vertices_list[1] =
-                this->interpolate_from_cubes(cube_table[i], 1, 2, _isovalue);
-        if (edge_table[cubeindex] & (1 << 2))
-            vertices_list[2] =
-                this->interpolate_from_cubes(cube_table[i], 2, 3, _isovalue);
-        if (edge_table[cubeindex] & (1 << 3))
-            vertices_list[3] =
-                this->interpolate_from_cubes(cube_table[i], 3, 0, _isovalue);
-        if (edge_table[cubeindex] & (1 << 4))
-            vertices_list[4] =
-                this->interpolate_from_cubes(cube_table[i], 4, 5, _isovalue);
-        if (edge_table[cubeindex] & (1 << 5))
-            vertices_list[5] =
-                this->interpolate_from_cubes(cube_table[i], 5, 6, _isovalue);
-        if (edge_table[cubeindex] & (1 << 6))
-            vertices_list[6] =
-                this->interpolate_from_cubes(cube_table[i], 6, 7, _isovalue);
-        if (edge_table[cubeindex] & (1 << 7))
-            vertices_list[7] =
-                this->interpolate_from_cubes(cube_table[i], 7, 4, _isovalue);
-        if (edge_table[cubeindex] & (1 << 8))
-            vertices_list[8] =
-                this->interpolate_from_cubes(cube_table[i], 0, 4, _isovalue);
-        if (edge_table[cubeindex] & (1 << 9))
-            vertices_list[9] =
-                this->interpolate_from_cubes(cube_table[i], 1, 5, _isovalue);
-        if (edge_table[cubeindex] & (1 << 10))
-            vertices_list[10] =
-                this->interpolate_from_cubes(cube_table[i], 2, 6, _isovalue);
-        if (edge_table[cubeindex] & (1 << 11))
-            vertices_list[11] =
-                this->interpolate_from_cubes(cube_table[i], 3, 7, _isovalue);
-
-        /* finally construct the triangles using the triangle table */
-        for(unsigned int i=0; triangle_table[cubeindex][i] != -1; i += 3) {
-            Triangle triangle(
-                    vertices_list[triangle_table[cubeindex][i]],
-                    vertices_list[triangle_table[cubeindex][i+1]],
-                    vertices_list[triangle_table[cubeindex][i+2]]);
-            /* push the triangle to the list */
-            push_back_mutex.lock();
-            this->triangles.push_back(triangle);
-            push_back_mutex.unlock();
-        }
+/**
+ * @brief      Construct the triangles for a slab of cells
+ *
+ * The vertices of the intersected edges are cached, for every isovalue, for
+ * the planes bounding the current layer of cells and for the edges in
+ * between. Cells are visited in raster order, skipping the cells of inactive
+ * bricks, which cannot be intersected. Only the cache entries around the
+ * visited cells are reset, which is sufficient as an intersected edge is
+ * shared exclusively by intersected cells.
+ *
+ * @param[in]  zstart         First layer of cells
+ * @param[in]  zstop          Last layer of cells (exclusive)
+ * @param[in]  _isovalues     The isovalues
+ * @param[in]  tetrahedra     Whether to use marching tetrahedra
+ * @param[in]  active_bricks  Per brick whether to visit its cells; empty
+ *                            when all cells are visited
+ * @param      slabs          Output vertices and triangles per isovalue
+ */
+void IsoSurface::march_slab(unsigned int zstart, unsigned int zstop, const std::vector<float>& _isovalues,
+                            bool tetrahedra, const std::vector<uint8_t>& active_bricks,
+                            std::vector<Slab>& slabs) const {
+    const unsigned int nx = this->grid_dimensions[0];
+    const unsigned int ny = this->grid_dimensions[1];
+    const size_t slice_size = (size_t)nx * ny;
+    const size_t nr_surfaces = _isovalues.size();
+    const GridStorage* grid = this->vp_ptr->get_grid_ptr();
+
+    // without bricks, the whole grid is treated as a single active brick
+    const MinMaxBricks* bricks = active_bricks.empty() ? nullptr : this->vp_ptr->get_bricks();
+    const unsigned int brick_size = bricks ? bricks->get_brick_size() :
+                                    std::max(std::max(nx, ny), this->grid_dimensions[2]);
+    const unsigned int nbx = bricks ? bricks->get_nr_bricks(0) : 1;
+    const unsigned int nby = bricks ? bricks->get_nr_bricks(1) : 1;
+
+    // ranges of cells along x to visit per row of bricks in the current layer of bricks
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> runs(nby);
+    unsigned int runs_layer = ~0u;
+
+    std::vector<std::vector<uint32_t>> plane_lo(nr_surfaces, std::vector<uint32_t>(slice_size * NR_PLANE_EDGES));
+    std::vector<std::vector<uint32_t>> plane_hi(nr_surfaces, std::vector<uint32_t>(slice_size * NR_PLANE_EDGES, UNSET_VERTEX));
+    std::vector<std::vector<uint32_t>> layer(nr_surfaces, std::vector<uint32_t>(slice_size * NR_LAYER_EDGES));
+
+    // values along the four grid rows bounding a row of cells, y running
+    // fastest followed by z
+    std::vector<float> rows[4];
+    for(auto& row : rows) {
+        row.resize(nx);
     }
 
-    std::cout << "Identified " << this->triangles.size() << " faces." << std::endl;
-}
+    for(unsigned int z = zstart; z < zstop; z++) {
+        // collect the runs of consecutive active bricks
+        const unsigned int bz = z / brick_size;
+        if(bz != runs_layer) {
+            runs_layer = bz;
+            for(unsigned int by=0; by<nby; by++) {
+                runs[by].clear();
+                for(unsigned int bx=0; bx<nbx; bx++) {
+                    if(bricks && !active_bricks[((size_t)bz * nby + by) * nbx + bx]) {
+                        continue;
+                    }
 
-void IsoSurface::construct_triangles_from_tetrahedra(float _isovalue) {
-    for(unsigned int i=0; i < tetrahedra_table.size(); i++) {
-
-        unsigned int tetidx = tetrahedra_table[i].get_tetrahedron_index();
-        glm::vec3 p[3];
-
-        switch(tetidx) {
-            case 0x0E:
-            case 0x01:
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 1, _isovalue);
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 2, _isovalue);
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 3, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-                break;
-            case 0x0D:
-            case 0x02:
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 1, 0, _isovalue);
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 1, 3, _isovalue);
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 1, 2, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-                break;
-            case 0x0C:
-            case 0x03:
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 3, _isovalue);
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 2, _isovalue);
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 1, 3, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 1, 2, _isovalue);
-                this->triangles.push_back(Triangle(p[2], p[0], p[1]));
-
-                break;
-            case 0x0B:
-            case 0x04:
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 2, 0, _isovalue);
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 2, 1, _isovalue);
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 2, 3, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-                break;
-            case 0x0A:
-            case 0x05:
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 1, _isovalue);
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 2, 3, _isovalue);
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 3, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 1, 2, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[2], p[1]));
-                break;
-            case 0x09:
-            case 0x06:
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 1, _isovalue);
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 1, 3, _isovalue);
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 2, 3, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 0, 2, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-                break;
-            case 0x07:
-            case 0x08:
-                p[0] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 3, 0, _isovalue);
-                p[1] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 3, 2, _isovalue);
-                p[2] = this->interpolate_from_tetrahedra(tetrahedra_table[i], 3, 1, _isovalue);
-                this->triangles.push_back(Triangle(p[0], p[1], p[2]));
-        break;
+                    const unsigned int xstart = bx * brick_size;
+                    const unsigned int xstop = std::min(xstart + brick_size, nx - 1);
+                    if(!runs[by].empty() && runs[by].back().second == xstart) {
+                        runs[by].back().second = xstop;
+                    } else {
+                        runs[by].emplace_back(xstart, xstop);
+                    }
+                }
+            }
         }
-    }
-}
 
-glm::vec3 IsoSurface::interpolate_from_cubes(const Cube &_cub, unsigned int _p1,
-    unsigned int _p2, float _isovalue) {
-    float v1 = _cub.get_value_from_vertex(_p1);
-    float v2 = _cub.get_value_from_vertex(_p2);
+        // reset the cached vertices on the edges of the cells to visit
+        for(size_t l=0; l<nr_surfaces; l++) {
+            std::swap(plane_lo[l], plane_hi[l]);
+            for(unsigned int by=0; by<nby; by++) {
+                for(unsigned int y = by * brick_size; y <= std::min((by + 1) * brick_size, ny - 1); y++) {
+                    for(const auto& run : runs[by]) {
+                        const size_t first = (size_t)y * nx + run.first;
+                        const size_t last = (size_t)y * nx + run.second + 1;
+                        std::fill(plane_hi[l].begin() + first * NR_PLANE_EDGES,
+                                  plane_hi[l].begin() + last * NR_PLANE_EDGES, UNSET_VERTEX);
+                        std::fill(layer[l].begin() + first * NR_LAYER_EDGES,
+                                  layer[l].begin() + last * NR_LAYER_EDGES, UNSET_VERTEX);
+                    }
+                }
+            }
+        }
 
-    glm::vec3 p1 = _cub.get_position_from_vertex(_p1);
-    glm::vec3 p2 = _cub.get_position_from_vertex(_p2);
+        for(unsigned int y = 0; y < ny - 1; y++) {
+            for(const auto& run : runs[y / brick_size]) {
+                for(unsigned int r=0; r<4; r++) {
+                    grid->read_row(y + (r & 1), z + (r >> 1), run.first, run.second + 1, rows[r].data());
+                }
 
-    glm::vec3 p;
-    float mu;
+                for(unsigned int x = run.first; x < run.second; x++) {
+                    float values[8];
+                    for(unsigned int v=0; v<8; v++) {
+                        const unsigned int r = cube_vertices[v][1] + 2 * cube_vertices[v][2];
+                        values[v] = rows[r][x - run.first + cube_vertices[v][0]];
+                    }
 
-    if(std::abs(_isovalue-v1) < PRECISION_LIMIT)
-        return p1;
-    if(std::abs(_isovalue-v2) < PRECISION_LIMIT)
-        return p2;
-    if(std::abs(v1-v2) < PRECISION_LIMIT)
-        return p1;
+                    for(size_t l=0; l<nr_surfaces; l++) {
+                        const float isovalue = _isovalues[l];
+
+                        unsigned int cubeindex = 0;
+                        for(unsigned int v=0; v<8; v++) {
+                            if(values[v] < isovalue) cubeindex |= (1 << v);
+                        }
+
+                        if(cubeindex == 0 || cubeindex == 255) {
+                            continue;
+                        }
+
+                        Slab& slab = slabs[l];
+
+                        // get the vertex on the edge between two cube vertices,
+                        // constructing it when the edge is encountered first
+                        auto vertex = [&](unsigned int v1, unsigned int v2) -> uint32_t {
+                            const EdgeSlot& slot = edge_slots[v1][v2];
+                            const size_t pos = (y + slot.dy) * nx + x + slot.dx;
+
+                            if(slot.cache == 0 && z == zstart && zstart > 0) {
+                                return PREVIOUS_SLAB | (uint32_t)(pos * NR_PLANE_EDGES + slot.dir);
+                            }
+
+                            uint32_t& idx = slot.cache == 2 ? layer[l][pos * NR_LAYER_EDGES + slot.dir] :
+                                            (slot.cache == 0 ? plane_lo[l] : plane_hi[l])[pos * NR_PLANE_EDGES + slot.dir];
+                            if(idx == UNSET_VERTEX) {
+                                idx = slab.vertices.size();
+                                slab.vertices.push_back(this->interpolate(x, y, z, slot.v1, slot.v2,
+                                                                          values[slot.v1], values[slot.v2],
+                                                                          isovalue));
+                            }
+                            return idx;
+                        };
+
+                        if(tetrahedra) {
+                            for(unsigned int t=0; t<6; t++) {
+                                this->construct_triangles_from_tetrahedron(cube_tetrahedra[t], values, isovalue, vertex, slab.indices);
+                            }
+                        } else {
+                            uint32_t edge_list[12];
+
+                            /* Find the edges where the surface intersects the cube */
+                            for(unsigned int e=0; e<12; e++) {
+                                if (edge_table[cubeindex] & (1 << e)) {
+                                    edge_list[e] = vertex(cube_edges[e][0], cube_edges[e][1]);
+                                }
+                            }
+
+                            /* finally construct the triangles using the triangle table */
+                            for(unsigned int i=0; triangle_table[cubeindex][i] != -1; i += 3) {
+                                slab.indices.push_back(edge_list[triangle_table[cubeindex][i]]);
+                                slab.indices.push_back(edge_list[triangle_table[cubeindex][i+1]]);
+                                slab.indices.push_back(edge_list[triangle_table[cubeindex][i+2]]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
 
-    mu = (_isovalue - v1) / (v2 - v1);
+    // the vertices on the top plane are shared with the next slab
+    for(size_t l=0; l<nr_surfaces; l++) {
+        slabs[l].top_plane = std::move(plane_hi[l]);
+    }
+}
 
-    p[0] = p1[0] + mu * (p2[0] - p1[0]);
-    p[1] = p1[1] + mu * (p2[1] - p1[1]);
-    p[2] = p1[2] + mu * (p2[2] - p1[2]);
+/**
+ * @brief      Construct the triangles of a single tetrahedron
+ *
+ * @param[in]  tet        Cube vertices of the tetrahedron
+ * @param[in]  values     Scalar field values at the cube vertices
+ * @param[in]  _isovalue  The isovalue
+ * @param[in]  vertex     Function yielding the vertex index of an edge
+ * @param      indices    Triangle indices
+ */
+template<typename VertexFunc>
+void IsoSurface::construct_triangles_from_tetrahedron(const unsigned int tet[4], const float values[8],
+                                                      float _isovalue, VertexFunc& vertex,
+                                                      std::vector<uint32_t>& indices) const {
+    unsigned int tetidx = 0;
+    for(unsigned int p=0; p<4; p++) {
+        if(values[tet[p]] < _isovalue) tetidx |= (1 << p);
+    }
 
-    return p;
+    auto edge = [&](unsigned int p1, unsigned int p2) {
+        return vertex(tet[p1], tet[p2]);
+    };
+
+    auto triangle = [&](uint32_t i1, uint32_t i2, uint32_t i3) {
+        indices.push_back(i1);
+        indices.push_back(i2);
+        indices.push_back(i3);
+    };
+
+    uint32_t p[3];
+
+    switch(tetidx) {
+        case 0x0E:
+        case 0x01:
+            triangle(edge(0, 1), edge(0, 2), edge(0, 3));
+            break;
+        case 0x0D:
+        case 0x02:
+            triangle(edge(1, 0), edge(1, 3), edge(1, 2));
+            break;
+        case 0x0C:
+        case 0x03:
+            p[0] = edge(0, 3);
+            p[1] = edge(0, 2);
+            p[2] = edge(1, 3);
+            triangle(p[0], p[1], p[2]);
+
+            p[0] = edge(1, 2);
+            triangle(p[2], p[0], p[1]);
+            break;
+        case 0x0B:
+        case 0x04:
+            triangle(edge(2, 0), edge(2, 1), edge(2, 3));
+            break;
+        case 0x0A:
+        case 0x05:
+            p[0] = edge(0, 1);
+            p[1] = edge(2, 3);
+            p[2] = edge(0, 3);
+            triangle(p[0], p[1], p[2]);
+            p[2] = edge(1, 2);
+            triangle(p[0], p[2], p[1]);
+            break;
+        case 0x09:
+        case 0x06:
+            p[0] = edge(0, 1);
+            p[1] = edge(1, 3);
+            p[2] = edge(2, 3);
+            triangle(p[0], p[1], p[2]);
+            p[1] = edge(0, 2);
+            triangle(p[0], p[1], p[2]);
+            break;
+        case 0x07:
+        case 0x08:
+            triangle(edge(3, 0), edge(3, 2), edge(3, 1));
+            break;
+    }
 }
 
-glm::vec3 IsoSurface::interpolate_from_tetrahedra(const Tetrahedron &_tet,
-    unsigned int _p1, unsigned int _p2, float _isovalue) {
-    float v1 = _tet.get_value_from_vertex(_p1);
-    float v2 = _tet.get_value_from_vertex(_p2);
-
-    glm::vec3 p1 = _tet.get_position_from_vertex(_p1);
-    glm::vec3 p2 = _tet.get_position_from_vertex(_p2);
+/**
+ * @brief      Construct the vertex on a cell edge by linear interpolation
+ *
+ * @param[in]  x          Grid position of the cell
+ * @param[in]  y          Grid position of the cell
+ * @param[in]  z          Grid position of the cell
+ * @param[in]  v1         First cube vertex of the edge
+ * @param[in]  v2         Second cube vertex of the edge
+ * @param[in]  val1       Scalar field value at the first cube vertex
+ * @param[in]  val2       Scalar field value at the second cube vertex
+ * @param[in]  _isovalue  The isovalue
+ *
+ * @return     Vertex position in real space
+ */
+glm::vec3 IsoSurface::interpolate(unsigned int x, unsigned int y, unsigned int z,
+                                  unsigned int v1, unsigned int v2,
+                                  float val1, float val2, float _isovalue) const {
+    const glm::vec3 p1(x + cube_vertices[v1][0], y + cube_vertices[v1][1], z + cube_vertices[v1][2]);
+    const glm::vec3 p2(x + cube_vertices[v2][0], y + cube_vertices[v2][1], z + cube_vertices[v2][2]);
 
     glm::vec3 p;
     float mu;
 
-    if(std::abs(_isovalue-v1) < PRECISION_LIMIT)
-        return p1;
-    if(std::abs(_isovalue-v2) < PRECISION_LIMIT)
-        return p2;
-    if(std::abs(v1-v2) < PRECISION_LIMIT)
-        return p1;
-
-    mu = (_isovalue - v1) / (v2 - v1);
+    if(std::abs(_isovalue-val1) < PRECISION_LIMIT) {
+        p = p1;
+    } else if(std::abs(_isovalue-val2) < PRECISION_LIMIT) {
+        p = p2;
+    } else if(std::abs(val1-val2) < PRECISION_LIMIT) {
+        p = p1;
+    } else {
+        mu = (_isovalue - val1) / (val2 - val1);
 
-    p[0] = p1[0] + mu * (p2[0] - p1[0]);
-    p[1] = p1[1] + mu * (p2[1] - p1[1]);
-    p[2] = p1[2] + mu * (p2[2] - p1[2]);
+        p[0] = p1[0] + mu * (p2[0] - p1[0]);
+        p[1] = p1[1] + mu * (p2[1] - p1[1]);
+        p[2] = p1[2] + mu * (p2[2] - p1[2]);
+    }
 
-    return p;
+    return glm::vec3(this->vp_ptr->grid_to_realspace(p[0], p[1], p[2]));
 }
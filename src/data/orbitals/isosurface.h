@@ -25,7 +25,8 @@
 #include <vector>
 #include <iostream>
 #include <cmath>
-#include <mutex>
+#include <algorithm>
+#include <cstdint>
 
 #include "edgetable.h"
 #include "triangletable.h"
@@ -33,106 +34,32 @@
 
 #define PRECISION_LIMIT 0.000000001
 
-/*
- *            z
- *            |
- *            4----5
- *         /|     /|
- *        7-|--6 |
- *        | 0--|-1--- y
- *        |/     |/
- *        3----2
- *     /
- *    x
- *
- */
-
-class Cube{
-private:
-    unsigned int i,j,k;                           // starting position of the cube
-    float values[8];                              // vector holding cube values
-    unsigned int cubidx;                          // cubeindex (whether there is an intersection)
-
-public:
-    Cube();
-
-    Cube(unsigned int _i, unsigned int _j, unsigned int _k, const ScalarField &_vp);
-
-    void set_cube_index(float _isovalue);
-
-    unsigned int get_cube_index() const;
-
-    float get_value_from_vertex(unsigned int _p) const;
-    glm::vec3 get_position_from_vertex(unsigned int _p) const;
-};
-
-/*
- *               + 0
- *              /|\
- *             / | \
- *            /  |  \
- *           /   |   \
- *          /    |    \
- *         /     |     \
- *        +-------------+ 1
- *       3 \     |     /
- *          \    |    /
- *           \   |   /
- *            \  |  /
- *             \ | /
- *              \|/
- *               + 2
- */
-
-class Tetrahedron{
-private:
-    unsigned int i,j,k;     //!< starting position of the cube
-    float values[4];
-    unsigned int tetidx;    //!< cubeindex (whether there is an intersection)
-    glm::vec3 pos[4];       //!< coordinates of the gridpoints
-
-public:
-    Tetrahedron(unsigned int _i, unsigned int _j, unsigned int _k, const ScalarField &_vp, unsigned int _pos);
-
-    void set_tetrahedron_index(float _isovalue);
-
-    unsigned int get_tetrahedron_index() const;
-
-    float get_value_from_vertex(unsigned int _p) const;
-
-    const glm::vec3& get_position_from_vertex(unsigned int _p) const;
-};
-
-class Triangle{
-public:
-    glm::vec3 p1, p2, p3;
-
-    Triangle();
-
-    Triangle(const glm::vec3 &_p1, const glm::vec3 &_p2, const glm::vec3 &_p3);
-
-    void transform_to_real(const ScalarField &_vp);
-
-    float get_x(unsigned int i) const;
-
-    float get_y(unsigned int i) const;
-
-    float get_z(unsigned int i) const;
-};
-
 /**
  * @brief      generates an isosurface using either the marching cubes or the
  *             marching tetrahedra algorithm, input is a (tabulated) scalar
  *             field
+ *
+ * The isosurface is stored as an indexed triangle mesh. Every vertex lies on
+ * a grid edge and is shared by all triangles touching that edge. Several
+ * isovalues can be extracted in a single pass, yielding one surface each.
  */
 class IsoSurface {
 private:
-    std::vector<Cube> cube_table;
-    std::vector<Tetrahedron> tetrahedra_table;
-    std::vector<Triangle> triangles;
-    ScalarField *vp_ptr;                // pointer to ScalarField obj
+    /**
+     * @brief Vertices and triangles of a slab of grid cells
+     */
+    struct Slab {
+        std::vector<glm::vec3> vertices;
+        std::vector<uint32_t> indices;      // local indices; flagged when owned by the previous slab
+        std::vector<uint32_t> top_plane;    // vertex indices of the edges in the top plane
+    };
+
+    std::vector<std::vector<glm::vec3>> vertices;    // vertex positions in real space per isovalue
+    std::vector<std::vector<unsigned int>> indices;  // triangle vertex indices per isovalue
+    std::vector<float> isovalues;                    // isovalue settings
+    const ScalarField *vp_ptr;                       // pointer to ScalarField obj
     unsigned int grid_dimensions[3];
-    float isovalue;                     // isovalue setting
+    unsigned int nr_threads = 0;        // number of threads; 0 uses all available
 
 public:
     /**
@@ -140,7 +67,7 @@ public:
      *
      * @param      _sf   pointer to ScalarField object
      */
-    IsoSurface(ScalarField *_sf);
+    IsoSurface(const ScalarField *_sf);
 
     /**
      * @brief      generate isosurface using marching cubes algorithm
@@ -149,6 +76,14 @@ public:
      */
     void marching_cubes(float _isovalue);
 
+    /**
+     * @brief      generate isosurfaces for several isovalues using the
+     *             marching cubes algorithm in a single pass over the grid
+     *
+     * @param[in]  _isovalues  The isovalues
+     */
+    void marching_cubes(const std::vector<float>& _isovalues);
+
     /**
      * @brief      generate isosurface using marching tetrahedra algorithm
      *
@@ -157,14 +92,62 @@ public:
     void marching_tetrahedra(float _isovalue);
 
     /**
-     * @brief      Gets the triangles pointer.
+     * @brief      generate isosurfaces for several isovalues using the
+     *             marching tetrahedra algorithm in a single pass over the grid
      *
-     * @return     The triangles pointer.
+     * @param[in]  _isovalues  The isovalues
      */
-    const std::vector<Triangle>* get_triangles_ptr() const;
+    void marching_tetrahedra(const std::vector<float>& _isovalues);
 
-    inline float get_isovalue() const {
-        return this->isovalue;
+    /**
+     * @brief      Get the number of surfaces, one per isovalue
+     *
+     * @return     Number of surfaces
+     */
+    inline size_t get_nr_surfaces() const {
+        return this->isovalues.size();
+    }
+
+    /**
+     * @brief      Get the vertices of an isosurface
+     *
+     * @param[in]  surface  Index of the isovalue
+     *
+     * @return     Vertex positions in real space
+     */
+    inline const std::vector<glm::vec3>& get_vertices(size_t surface = 0) const {
+        return this->vertices[surface];
+    }
+
+    /**
+     * @brief      Get the triangle indices of an isosurface
+     *
+     * @param[in]  surface  Index of the isovalue
+     *
+     * @return     Vertex indices, three per triangle
+     */
+    inline const std::vector<unsigned int>& get_indices(size_t surface = 0) const {
+        return this->indices[surface];
+    }
+
+    /**
+     * @brief      Set the number of threads used for the isosurface
+     *             construction
+     *
+     * @param[in]  _nr_threads  Number of threads; 0 uses all available threads
+     */
+    void set_nr_threads(unsigned int _nr_threads);
+
+    /**
+     * @brief      Get the number of threads used for the isosurface
+     *             construction
+     *
+     * @return     Number of threads
+     */
+    int get_nr_threads() const;
+
+    inline float get_isovalue(size_t surface = 0) const {
+        return this->isovalues[surface];
     }
 
     inline const ScalarField* get_scalar_field() const {
@@ -172,12 +155,17 @@ public:
     }
 
 private:
-    void sample_grid_with_cubes(float _isovalue);
-    void sample_grid_with_tetrahedra(float _isovalue);
-    void construct_triangles_from_cubes(float _isovalue);
-    void construct_triangles_from_tetrahedra(float _isovalue);
-    glm::vec3 interpolate_from_cubes(const Cube &_cub, unsigned int _p1, unsigned int _p2, float _isovalue);
-    glm::vec3 interpolate_from_tetrahedra(const Tetrahedron &_cub, unsigned int _p1, unsigned int _p2, float _isovalue);
+    void march(const std::vector<float>& _isovalues, bool tetrahedra);
+    void march_slab(unsigned int zstart, unsigned int zstop, const std::vector<float>& _isovalues,
+                    bool tetrahedra, const std::vector<uint8_t>& active_bricks,
+                    std::vector<Slab>& slabs) const;
+
+    template<typename VertexFunc>
+    void construct_triangles_from_tetrahedron(const unsigned int tet[4], const float values[8], float _isovalue,
+                                              VertexFunc& vertex, std::vector<uint32_t>& indices) const;
+
+    glm::vec3 interpolate(unsigned int x, unsigned int y, unsigned int z, unsigned int v1, unsigned int v2,
+                          float val1, float val2, float _isovalue) const;
 };
 
 #endif //_ISOSURFACE_H
@@ -26,11 +26,14 @@
  *
  * @param[in]  _sf   pointer to scalar field
  * @param[in]  _is   pointer to isosurface
+ * @param[in]  _surface  index of the isovalue in the isosurface
  */
 IsoSurfaceMesh::IsoSurfaceMesh(const ScalarField* _sf,
-                               const IsoSurface* _is) :
+                               const IsoSurface* _is,
+                               size_t _surface) :
     sf(_sf),
-    is(_is) {
+    is(_is),
+    surface(_surface) {
 }
 
 /**
@@ -39,96 +42,53 @@ IsoSurfaceMesh::IsoSurfaceMesh(const ScalarField* _sf,
  * @param[in]  center  whether to center structure
  */
 void IsoSurfaceMesh::construct_mesh(bool center) {
-   // grab center
-    this->center = this->sf->get_mat_unitcell() * glm::vec3(0.5, 0.5, 0.5);
-
-    for(unsigned int i=0; i<this->is->get_triangles_ptr()->size(); i++) {
-        this->texcoords.push_back(glm::vec2(0,0));
-        this->texcoords.push_back(glm::vec2(0,1));
-        this->texcoords.push_back(glm::vec2(1,0));
-
-        this->indices.push_back(this->get_index_vertex(is->get_triangles_ptr()->at(i).p1));
-        this->indices.push_back(this->get_index_vertex(is->get_triangles_ptr()->at(i).p2));
-        this->indices.push_back(this->get_index_vertex(is->get_triangles_ptr()->at(i).p3));
-    }
-
-    // build vertex vector from unordered map
-    this->vertices.resize(this->vertices_map.size());
-    for(auto it : this->vertices_map) {
-        this->vertices[it.second] = it.first;
+    // grab center, i.e. the position of the central grid point
+    unsigned int grid_dimensions[3];
+    this->sf->copy_grid_dimensions(grid_dimensions);
+    this->center = glm::vec3(this->sf->grid_to_realspace((double)(grid_dimensions[0] - 1) / 2.0,
+                                                         (double)(grid_dimensions[1] - 1) / 2.0,
+                                                         (double)(grid_dimensions[2] - 1) / 2.0));
+
+    // the isosurface already shares vertices between adjacent triangles
+    this->vertices = this->is->get_vertices(this->surface);
+    this->indices = this->is->get_indices(this->surface);
+
+    // calculate vertex normals from the exact gradient when the scalar field
+    // stems from an analytic source, else from the adjacent faces
+    if(this->sf->has_analytic_gradient()) {
+        this->calculate_normals_from_gradient();
+    } else {
+        this->calculate_normals_from_polygons();
     }
 
-    // calculate vertex normals based on gradient of scalar field
-    this->calculate_normals_from_polygons();
-
     // set order of vertex indices based on face normals
     this->align_vertices_order_with_normals();
 
     // center structure
     if(center) {
-        glm::vec3 sum = this->sf->get_mat_unitcell() * glm::vec3(0.5f, 0.5f, 0.5f);
-
         #pragma omp parallel for
         for(unsigned int i=0; i<this->vertices.size(); i++) {
-           this->vertices[i] -= sum;
+           this->vertices[i] -= this->center;
         }
     }
 }
 
 /**
- * @brief      get the index of a vertex from unordered map
- *
- * @param[in]  v     vertex coordinates
- *
- * @return     the index
+ * @brief      Calculates the normals from the analytic gradient of the
+ *             scalar field
  */
-unsigned int IsoSurfaceMesh::get_index_vertex(const glm::vec3 v) {
-    auto got = this->vertices_map.find(v);
-    if(got != this->vertices_map.end()) {
-        return got->second;
-    } else {
-        this->vertices_map.emplace(v, this->vertices_map.size());
-        return this->get_index_vertex(v);
-    }
-}
+void IsoSurfaceMesh::calculate_normals_from_gradient() {
+    this->sf->calculate_gradients(this->vertices, this->normals);
 
-/**
- * @brief      Calculates the normals from scalar field.
- */
-void IsoSurfaceMesh::calculate_normals_from_scalar_field() {
-    static const double dev = 0.01;
-    this->normals.resize(this->vertices.size(), glm::vec3(0.0f, 0.0f, 0.0f));
+    // the normals point away from the enclosed lobe, i.e. along the gradient
+    // for negative isovalues and against it for positive isovalues
+    const float sign = this->is->get_isovalue(this->surface) > 0.0 ? -1.0f : 1.0f;
 
-    // calculate normal vectors for each vertex
     #pragma omp parallel for
-    for(unsigned int i=0; i<this->vertices.size(); i++) {
-        // get derivatives
-        double dx0 = sf->get_value_interp(this->vertices[i][0] - 2.0 * dev, this->vertices[i][1], this->vertices[i][2]);
-        double dx1 = sf->get_value_interp(this->vertices[i][0] - dev, this->vertices[i][1], this->vertices[i][2]);
-        double dx2 = sf->get_value_interp(this->vertices[i][0] + dev, this->vertices[i][1], this->vertices[i][2]);
-        double dx3 = sf->get_value_interp(this->vertices[i][0] + 2.0 * dev, this->vertices[i][1], this->vertices[i][2]);
-
-        double dy0 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1] - 2.0 * dev, this->vertices[i][2]);
-        double dy1 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1] - dev, this->vertices[i][2]);
-        double dy2 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1] + dev, this->vertices[i][2]);
-        double dy3 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1] + 2.0 * dev, this->vertices[i][2]);
-
-        double dz0 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1], this->vertices[i][2] - 2.0 * dev);
-        double dz1 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1], this->vertices[i][2] - dev);
-        double dz2 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1], this->vertices[i][2] + dev);
-        double dz3 = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1], this->vertices[i][2] + 2.0 * dev);
-
-        double cc = sf->get_value_interp(this->vertices[i][0], this->vertices[i][1], this->vertices[i][2]);
-
-        // calculate gradient using 5 point stencil (note that center point is not used when calculating gradient)
-        double dx = (dx0 - 8.0 * dx1 + 8.0 * dx2 - dx3) / (12.0 * dev);
-        double dy = (dy0 - 8.0 * dy1 + 8.0 * dy2 - dy3) / (12.0 * dev);
-        double dz = (dz0 - 8.0 * dz1 + 8.0 * dz2 - dz3) / (12.0 * dev);
-
-        if(cc < 0) { // flip normal vector for negative isovalue
-            this->normals[i] = glm::normalize(glm::vec3(dx, dy, dz));
-        } else {
-            this->normals[i] = glm::normalize(glm::vec3(-dx, -dy, -dz));
+    for(int i=0; i<(int)this->normals.size(); i++) {
+        const float len = glm::length(this->normals[i]);
+        if(len > 0.0f) {
+            this->normals[i] *= sign / len;
         }
     }
 }
@@ -139,7 +99,8 @@ void IsoSurfaceMesh::calculate_normals_from_scalar_field() {
 void IsoSurfaceMesh::calculate_normals_from_polygons() {
     this->normals.resize(this->vertices.size(), glm::vec3(0.0f, 0.0f, 0.0f));
 
-    #pragma omp parallel for
+    // accumulate face normals; this loop is kept serial as faces sharing a
+    // vertex would otherwise write to the same normal concurrently
     for(unsigned int i=0; i<this->indices.size(); i += 3) {
         const unsigned int idx1 = this->indices[i];
         const unsigned int idx2 = this->indices[i+1];
@@ -152,8 +113,10 @@ void IsoSurfaceMesh::calculate_normals_from_polygons() {
         float area = glm::length(glm::cross(v2 - v1, v3 - v1)) / 2.0f;
         glm::vec3 direction = glm::cross(v2 - v1, v3 - v1);
 
-        if(area < 0.0) {
-            std::cout << area << std::endl;
+        // skip degenerate faces, which occur when vertices snap onto a
+        // grid point
+        if(area <= 0.0f) {
+            continue;
         }
 
         this->normals[idx1] += direction / area;
@@ -163,7 +126,7 @@ void IsoSurfaceMesh::calculate_normals_from_polygons() {
 
     #pragma omp parallel for
     for(unsigned int i=0; i<this->normals.size(); i++) {
-        if(this->is->get_isovalue() > 0.0) {
+        if(this->is->get_isovalue(this->surface) > 0.0) {
             this->normals[i] = glm::normalize(-this->normals[i]);
         } else {
             this->normals[i] = glm::normalize(this->normals[i]);
@@ -25,42 +25,24 @@
 #include <fstream>
 #include <set>
 #include <vector>
-#include <unordered_map>
 
 #define GLM_FORCE_SWIZZLE
 #include <glm/glm.hpp>
 
 #include "isosurface.h"
 
-/**
- * @brief      structure to put glm::vec3 in a map
- */
-struct KeyFuncs
-{
-    size_t operator()(const glm::vec3& k)const
-    {
-        return std::hash<float>()(k.x) ^ std::hash<float>()(k.y) ^ std::hash<float>()(k.z);
-    }
-
-    bool operator()(const glm::vec3& a, const glm::vec3& b)const
-    {
-            return a.x == b.x && a.y == b.y && a.z == b.z;
-    }
-};
-
 /**
  * @brief      Class for iso surface mesh.
  */
 class IsoSurfaceMesh{
 private:
-    std::unordered_map<glm::vec3, uint32_t, KeyFuncs, KeyFuncs> vertices_map;
     std::vector<glm::vec3> vertices;
     std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> texcoords;
     std::vector<uint32_t> indices;
 
     const ScalarField* sf;
     const IsoSurface* is;
+    size_t surface;                     // index of the isovalue in the isosurface
 
     glm::vec3 center;
 
@@ -70,8 +52,9 @@ public:
      *
      * @param[in]  _sf   pointer to scalar field
      * @param[in]  _is   pointer to isosurface
+     * @param[in]  _surface  index of the isovalue in the isosurface
      */
-    IsoSurfaceMesh(const ScalarField* _sf, const IsoSurface* _is);
+    IsoSurfaceMesh(const ScalarField* _sf, const IsoSurface* _is, size_t _surface = 0);
 
     /**
      * @brief      construct surface mesh
@@ -98,18 +81,10 @@ public:
 
 private:
     /**
-     * @brief      get the index of a vertex from unordered map
-     *
-     * @param[in]  v     vertex coordinates
-     *
-     * @return     the index
-     */
-    unsigned int get_index_vertex(const glm::vec3 v);
-
-    /**
-     * @brief      Calculates the normals from scalar field.
+     * @brief      Calculates the normals from the analytic gradient of the
+     *             scalar field
      */
-    void calculate_normals_from_scalar_field();
+    void calculate_normals_from_gradient();
 
     /**
      * @brief      Calculates the normals from polygons
@@ -62,28 +62,24 @@ double laguerre(int n, double x) {
  * @return     value at x of the nth/mth Associated Laguerre polynomial
  */
 double laguerre_l(int n, int m, double x) {
-    std::vector<double> v(n+1);
-
     if (n < 0) {
         return -1;
     }
 
-    v[0] = 1.0;
-    for (int i = 1; i <= n; i++) {
-        v[i] = 0.0;
-    }
-
+    // three-term recurrence only requires the two previous polynomials
+    double v0 = 1.0;
     if (n == 0) {
-        return v[0];
+        return v0;
     }
 
-    v[1] = (double)(m + 1) - x;
-
+    double v1 = (double)(m + 1) - x;
     for (int i = 2; i <= n; i++) {
-        v[i] = (((double)(m + 2 * i - 1) - x) * v[i-1]
-               + ( double ) (-m - i + 1 ) * v[i-2])
-               / ( double ) (i);
+        const double v2 = (((double)(m + 2 * i - 1) - x) * v1
+                          + ( double ) (-m - i + 1 ) * v0)
+                          / ( double ) (i);
+        v0 = v1;
+        v1 = v2;
     }
 
-    return v[n];
+    return v1;
 }
@@ -63,27 +63,30 @@ double legendre (int n, double x) {
  * @return     value at x of the nth/mth Associated Legendre polynomial
  */
 double legendre_p (int n, int m, double x) {
-    std::vector<double> v(n+1, 0.0);
-
-    if(m <= n ) {
-        v[m] = 1.0;
+    if(m > n) {
+        return 0.0;
+    }
 
-        double fact = 1.0;
-        for(int k = 0; k < m; k++) {
-            v[m] *= -fact * std::sqrt(1.0 - x * x);
-            fact += 2.0;
-        }
+    // three-term recurrence only requires the two previous polynomials
+    double v0 = 1.0;
+    double fact = 1.0;
+    for(int k = 0; k < m; k++) {
+        v0 *= -fact * std::sqrt(1.0 - x * x);
+        fact += 2.0;
     }
 
-    if(m + 1 <= n ) {
-        v[m+1] = x * ( double ) ( 2 * m + 1 ) * v[m];
+    if(n == m) {
+        return v0;
     }
 
+    double v1 = x * ( double ) ( 2 * m + 1 ) * v0;
     for(int j = m + 2; j <= n; j++ ) {
-        v[j] = ((double)(2 * j - 1 ) * x * v[(j-1)]
-                + (double)(- j - m + 1 ) * v[(j-2)])
-                / (double)(j - m);
+        const double v2 = ((double)(2 * j - 1 ) * x * v1
+                          + (double)(- j - m + 1 ) * v0)
+                          / (double)(j - m);
+        v0 = v1;
+        v1 = v2;
     }
 
-    return v[n];
+    return v1;
 }
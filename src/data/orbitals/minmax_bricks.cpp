@@ -0,0 +1,182 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#include "minmax_bricks.h"
+
+/**
+ * @brief      Construct the hierarchy for a scalar field
+ *
+ * @param[in]  grid         Values of the scalar field
+ * @param[in]  _brick_size  Number of cells along each edge of a brick
+ */
+MinMaxBricks::MinMaxBricks(const GridStorage& grid, unsigned int _brick_size) :
+    brick_size(std::max(_brick_size, 1u)) {
+
+    const unsigned int nx = grid.get_dimension(0);
+    const unsigned int ny = grid.get_dimension(1);
+    const unsigned int nz = grid.get_dimension(2);
+    if(nx < 2 || ny < 2 || nz < 2) {
+        return;
+    }
+
+    // the bricks share their boundary grid points with their neighbours
+    Level bricks;
+    for(unsigned int a=0; a<3; a++) {
+        bricks.dims[a] = (grid.get_dimension(a) - 2) / this->brick_size + 1;
+    }
+    const size_t nr_bricks = (size_t)bricks.dims[0] * bricks.dims[1] * bricks.dims[2];
+    bricks.minval.resize(nr_bricks);
+    bricks.maxval.resize(nr_bricks);
+
+    // values are compared in single precision, as during the extraction
+    #pragma omp parallel
+    {
+        std::vector<float> row(this->brick_size + 1);
+
+        #pragma omp for
+        for(int bz=0; bz<(int)bricks.dims[2]; bz++) {
+            for(unsigned int by=0; by<bricks.dims[1]; by++) {
+                for(unsigned int bx=0; bx<bricks.dims[0]; bx++) {
+                    float lo = (float)grid.get(bx * this->brick_size, by * this->brick_size, bz * this->brick_size);
+                    float hi = lo;
+
+                    const unsigned int zstop = std::min((bz + 1) * this->brick_size, nz - 1);
+                    const unsigned int ystop = std::min((by + 1) * this->brick_size, ny - 1);
+                    const unsigned int xstart = bx * this->brick_size;
+                    const unsigned int xstop = std::min((bx + 1) * this->brick_size, nx - 1);
+                    for(unsigned int z=bz * this->brick_size; z<=zstop; z++) {
+                        for(unsigned int y=by * this->brick_size; y<=ystop; y++) {
+                            grid.read_row(y, z, xstart, xstop + 1, row.data());
+                            for(unsigned int x=0; x<=xstop-xstart; x++) {
+                                lo = std::min(lo, row[x]);
+                                hi = std::max(hi, row[x]);
+                            }
+                        }
+                    }
+
+                    const size_t idx = ((size_t)bz * bricks.dims[1] + by) * bricks.dims[0] + bx;
+                    bricks.minval[idx] = lo;
+                    bricks.maxval[idx] = hi;
+                }
+            }
+        }
+    }
+    this->levels.push_back(std::move(bricks));
+
+    // merge 2x2x2 nodes until a single node remains
+    while(this->levels.back().dims[0] > 1 || this->levels.back().dims[1] > 1 || this->levels.back().dims[2] > 1) {
+        const Level& prev = this->levels.back();
+        Level next;
+        for(unsigned int a=0; a<3; a++) {
+            next.dims[a] = (prev.dims[a] + 1) / 2;
+        }
+        next.minval.resize((size_t)next.dims[0] * next.dims[1] * next.dims[2]);
+        next.maxval.resize(next.minval.size());
+
+        for(unsigned int k=0; k<next.dims[2]; k++) {
+            for(unsigned int j=0; j<next.dims[1]; j++) {
+                for(unsigned int i=0; i<next.dims[0]; i++) {
+                    float lo = prev.minval[((size_t)2 * k * prev.dims[1] + 2 * j) * prev.dims[0] + 2 * i];
+                    float hi = prev.maxval[((size_t)2 * k * prev.dims[1] + 2 * j) * prev.dims[0] + 2 * i];
+                    for(unsigned int z=2*k; z<std::min(2*k+2, prev.dims[2]); z++) {
+                        for(unsigned int y=2*j; y<std::min(2*j+2, prev.dims[1]); y++) {
+                            for(unsigned int x=2*i; x<std::min(2*i+2, prev.dims[0]); x++) {
+                                const size_t idx = ((size_t)z * prev.dims[1] + y) * prev.dims[0] + x;
+                                lo = std::min(lo, prev.minval[idx]);
+                                hi = std::max(hi, prev.maxval[idx]);
+                            }
+                        }
+                    }
+
+                    const size_t idx = ((size_t)k * next.dims[1] + j) * next.dims[0] + i;
+                    next.minval[idx] = lo;
+                    next.maxval[idx] = hi;
+                }
+            }
+        }
+
+        this->levels.push_back(std::move(next));
+    }
+}
+
+/**
+ * @brief      Find the bricks that may contain part of an isosurface
+ *
+ * @param[in]  isovalues  The isovalues
+ * @param      active     Per brick, x running fastest, whether its value
+ *                        range straddles any of the isovalues
+ */
+void MinMaxBricks::find_active_bricks(const std::vector<float>& isovalues, std::vector<uint8_t>& active) const {
+    if(this->levels.empty()) {
+        active.clear();
+        return;
+    }
+
+    const Level& bricks = this->levels.front();
+    active.assign((size_t)bricks.dims[0] * bricks.dims[1] * bricks.dims[2], 0);
+    this->descend(this->levels.size() - 1, 0, 0, 0, isovalues, active);
+}
+
+/**
+ * @brief      Mark the active bricks below a node of the hierarchy
+ *
+ * A cell is intersected by the isosurface when some of its corners lie below
+ * the isovalue and others do not, hence a node is only visited when its
+ * smallest value lies below and its largest value at or above the isovalue.
+ *
+ * @param[in]  level      Level of the node
+ * @param[in]  i          Position of the node along x
+ * @param[in]  j          Position of the node along y
+ * @param[in]  k          Position of the node along z
+ * @param[in]  isovalues  The isovalues
+ * @param      active     Per brick whether it is active
+ */
+void MinMaxBricks::descend(unsigned int level, unsigned int i, unsigned int j, unsigned int k,
+                           const std::vector<float>& isovalues, std::vector<uint8_t>& active) const {
+    const Level& node = this->levels[level];
+    const size_t idx = ((size_t)k * node.dims[1] + j) * node.dims[0] + i;
+
+    bool straddles = false;
+    for(float isovalue : isovalues) {
+        if(node.minval[idx] < isovalue && node.maxval[idx] >= isovalue) {
+            straddles = true;
+            break;
+        }
+    }
+
+    if(!straddles) {
+        return;
+    }
+
+    if(level == 0) {
+        active[idx] = 1;
+        return;
+    }
+
+    const Level& child = this->levels[level - 1];
+    for(unsigned int z=2*k; z<std::min(2*k+2, child.dims[2]); z++) {
+        for(unsigned int y=2*j; y<std::min(2*j+2, child.dims[1]); y++) {
+            for(unsigned int x=2*i; x<std::min(2*i+2, child.dims[0]); x++) {
+                this->descend(level - 1, x, y, z, isovalues, active);
+            }
+        }
+    }
+}
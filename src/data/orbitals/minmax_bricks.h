@@ -0,0 +1,102 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef _MINMAX_BRICKS_H
+#define _MINMAX_BRICKS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "grid_storage.h"
+
+/**
+ * @brief      Hierarchy of the value ranges of bricks of grid cells
+ *
+ * The cells of a scalar field are grouped into cubic bricks, each storing the
+ * smallest and largest value of its grid points. Every next level of the
+ * hierarchy merges 2x2x2 nodes of the previous one. A brick can only contain
+ * part of an isosurface when its value range straddles the isovalue, such
+ * that the remaining bricks are skipped during extraction.
+ */
+class MinMaxBricks {
+private:
+    /**
+     * @brief      Value ranges of a single level of the hierarchy
+     */
+    struct Level {
+        unsigned int dims[3];       // number of nodes along each axis
+        std::vector<float> minval;  // smallest value per node
+        std::vector<float> maxval;  // largest value per node
+    };
+
+    unsigned int brick_size;        // number of cells along each edge of a brick
+    std::vector<Level> levels;      // bricks first, coarsest node last
+
+public:
+    /**
+     * @brief      Construct the hierarchy for a scalar field
+     *
+     * @param[in]  grid         Values of the scalar field
+     * @param[in]  _brick_size  Number of cells along each edge of a brick
+     */
+    MinMaxBricks(const GridStorage& grid, unsigned int _brick_size = 8);
+
+    inline unsigned int get_brick_size() const {
+        return this->brick_size;
+    }
+
+    /**
+     * @brief      Get the number of bricks along an axis
+     *
+     * @param[in]  axis  The axis
+     *
+     * @return     Number of bricks
+     */
+    inline unsigned int get_nr_bricks(unsigned int axis) const {
+        return this->levels.empty() ? 0 : this->levels[0].dims[axis];
+    }
+
+    /**
+     * @brief      Find the bricks that may contain part of an isosurface
+     *
+     * @param[in]  isovalues  The isovalues
+     * @param      active     Per brick, x running fastest, whether its value
+     *                        range straddles any of the isovalues
+     */
+    void find_active_bricks(const std::vector<float>& isovalues, std::vector<uint8_t>& active) const;
+
+private:
+    /**
+     * @brief      Mark the active bricks below a node of the hierarchy
+     *
+     * @param[in]  level      Level of the node
+     * @param[in]  i          Position of the node along x
+     * @param[in]  j          Position of the node along y
+     * @param[in]  k          Position of the node along z
+     * @param[in]  isovalues  The isovalues
+     * @param      active     Per brick whether it is active
+     */
+    void descend(unsigned int level, unsigned int i, unsigned int j, unsigned int k,
+                 const std::vector<float>& isovalues, std::vector<uint8_t>& active) const;
+};
+
+#endif //_MINMAX_BRICKS_H
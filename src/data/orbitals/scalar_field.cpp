@@ -22,64 +22,116 @@
 #include "scalar_field.h"
 
 /**
- * @brief      constructor
+ * @brief      Construct a zero-valued cubic scalar field
  *
- * @param[in]  _filename   url to filename
- * @param[in]  _flag_is_locpot  whether this file is a locpot
+ * @param[in]  _gridsize    Number of grid points along each axis
+ * @param[in]  _resolution  Distance between two grid points
+ * @param[in]  _precision   Precision of the stored values
+ * @param[in]  _layout      Layout of the stored values
  */
-ScalarField::ScalarField(unsigned int _gridsize, double _resolution) :
+ScalarField::ScalarField(unsigned int _gridsize, double _resolution,
+                         GridStorage::Precision _precision, GridStorage::Layout _layout) :
     gridsize(_gridsize),
-    resolution(_resolution) {
+    resolution(_resolution),
+    storage(_gridsize, _gridsize, _gridsize, _precision, _layout) {
 
     this->init();
 }
 
+/**
+ * @brief      Evaluate a wave function on the grid
+ *
+ * The grid is centered at the origin and hydrogen-like orbitals are either
+ * even or odd under reflection of each Cartesian axis. Hence, only a single
+ * octant (including the central planes) is evaluated by a GridEvaluator and
+ * every evaluated row is written, mirrored with the corresponding sign, to
+ * its images in the other seven octants.
+ *
+ * @param[in]  wf    The wave function
+ * @param[in]  sgnd  Whether to store the signed value or its magnitude
+ */
 void ScalarField::load_wavefunction(const WaveFunction &wf, bool sgnd) {
-    double r = 0;
-    double phi = 0;
-    double theta = 0;
-
-    unsigned int i=0, j=0, k=0;
-
-    if(sgnd) {
-        for(double x = -(double)(gridsize - 1)/2.0 * resolution; x <= (gridsize - 1)/2.0 * resolution; x += resolution) {
-            j = 0;
-            for(double y = -(double)(gridsize - 1)/2.0 * resolution; y <= (gridsize - 1)/2.0 * resolution; y += resolution) {
-                k = 0;
-                for(double z = -(double)(gridsize - 1)/2.0 * resolution; z <= (gridsize - 1)/2.0 * resolution; z += resolution) {
-                    /* transform to spherical coordinates */
-                    r = std::sqrt(x*x + y*y + z*z);
-                    phi = std::atan2(y, x);
-                    theta = std::acos(z / r);
-
-                    /* obtain wavefunction value from object */
-                    this->set_value(i, j, k, wf.value(r, theta, phi));
-                    k++;
+    const double half = (double)(this->gridsize - 1) / 2.0 * this->resolution;
+    this->evaluator = std::make_shared<const GridEvaluator>(wf, std::sqrt(3.0) * half);
+    this->origin = glm::dvec3(half, half, half);
+    const GridEvaluator& evaluator = *this->evaluator;
+
+    const int nx = this->grid_dimensions[0];
+    const int ny = this->grid_dimensions[1];
+    const int nz = this->grid_dimensions[2];
+
+    // number of grid points in the evaluated octant along each axis
+    const int hx = (nx + 1) / 2;
+    const int hy = (ny + 1) / 2;
+    const int hz = (nz + 1) / 2;
+
+    // signs to apply when mirroring; the magnitude is even in every axis
+    const double px = sgnd ? (double)evaluator.get_parity(0) : 1.0;
+    const double py = sgnd ? (double)evaluator.get_parity(1) : 1.0;
+    const double pz = sgnd ? (double)evaluator.get_parity(2) : 1.0;
+
+    #pragma omp parallel
+    {
+        std::vector<double> row(nx);
+
+        #pragma omp for collapse(2) schedule(static)
+        for(int k=0; k<hz; k++) {
+            for(int j=0; j<hy; j++) {
+                evaluator.evaluate_row(-half, this->resolution,
+                                       -half + (double)j * this->resolution,
+                                       -half + (double)k * this->resolution,
+                                       hx, row.data());
+                if(!sgnd) {
+                    for(int i=0; i<hx; i++) {
+                        row[i] = std::abs(row[i]);
+                    }
                 }
-                j++;
-            }
-            i++;
-        }
-    } else {
-        for(double x = -(double)(gridsize - 1)/2.0 * resolution; x <= (gridsize - 1)/2.0 * resolution; x += resolution) {
-            j = 0;
-            for(double y = -(double)(gridsize - 1)/2.0 * resolution; y <= (gridsize - 1)/2.0 * resolution; y += resolution) {
-                k = 0;
-                for(double z = -(double)(gridsize - 1)/2.0 * resolution; z <= (gridsize - 1)/2.0 * resolution; z += resolution) {
-                    /* transform to spherical coordinates */
-                    r = std::sqrt(x*x + y*y + z*z);
-                    phi = std::atan2(y, x);
-                    theta = std::acos(z / r);
-
-                    /* obtain wavefunction value from object */
-                    this->set_value(i, j, k, std::abs(wf.value(r, theta, phi)));
-                    k++;
+
+                // mirror in x
+                for(int i=hx; i<nx; i++) {
+                    row[i] = px * row[nx - 1 - i];
                 }
-                j++;
+
+                // mirror in y and z; rows on the central planes are their own image
+                this->storage.write_row(j, k, row.data());
+                this->storage.write_row(ny - 1 - j, k, row.data(), py);
+                this->storage.write_row(j, nz - 1 - k, row.data(), pz);
+                this->storage.write_row(ny - 1 - j, nz - 1 - k, row.data(), py * pz);
             }
-            i++;
         }
     }
+
+    this->build_bricks();
+}
+
+/**
+ * @brief      Build the hierarchy of value ranges of bricks of cells,
+ *             used to skip empty regions during isosurface extraction
+ *
+ * @param[in]  brick_size  Number of cells along each edge of a brick
+ */
+void ScalarField::build_bricks(unsigned int brick_size) {
+    this->bricks = std::make_shared<const MinMaxBricks>(this->storage, brick_size);
+}
+
+/**
+ * @brief      Evaluate the analytic gradient at a set of points
+ *
+ * @param[in]  points     Real-space positions
+ * @param      gradients  Gradients at the positions
+ */
+void ScalarField::calculate_gradients(const std::vector<glm::vec3>& points, std::vector<glm::vec3>& gradients) const {
+    if(!this->evaluator) {
+        throw std::logic_error("Scalar field has no analytic source to evaluate gradients from.");
+    }
+
+    gradients.resize(points.size());
+
+    #pragma omp parallel for schedule(static)
+    for(int i=0; i<(int)points.size(); i++) {
+        const glm::dvec3 p = glm::dvec3(points[i]) - this->origin;
+        gradients[i] = glm::vec3(this->evaluator->gradient(p[0], p[1], p[2]));
+    }
 }
 
 /**
@@ -89,9 +141,16 @@ void ScalarField::load_wavefunction(const WaveFunction &wf, bool sgnd) {
  */
 void ScalarField::save_to_df3(const std::string& filename) {
     // get largest and smallest value
-    auto minmax = std::minmax_element(this->gridptr.begin(), this->gridptr.end());
-    double min = *minmax.first;
-    double max = *minmax.second;
+    double min = this->get_value(0, 0, 0);
+    double max = min;
+    for(unsigned int k=0; k<this->grid_dimensions[2]; k++) {
+        for(unsigned int j=0; j<this->grid_dimensions[1]; j++) {
+            for(unsigned int i=0; i<this->grid_dimensions[0]; i++) {
+                min = std::min(min, this->get_value(i, j, k));
+                max = std::max(max, this->get_value(i, j, k));
+            }
+        }
+    }
     double ival = max - min;
 
     std::ofstream out(filename, std::ios::binary);
@@ -112,10 +171,14 @@ void ScalarField::save_to_df3(const std::string& filename) {
     byteswap = (nz>>8) | (nz<<8);
     out.write((char*)&byteswap, sizeof(uint16_t));
 
-    for(unsigned int i=0; i<this->gridptr.size(); i++) {
-        uint16_t val = (uint16_t)((this->gridptr[i] - min) / ival * 65536);
-        byteswap = (val>>8) | (val<<8);
-        out.write((char*)&byteswap, sizeof(uint16_t));
+    for(unsigned int k=0; k<this->grid_dimensions[2]; k++) {
+        for(unsigned int j=0; j<this->grid_dimensions[1]; j++) {
+            for(unsigned int i=0; i<this->grid_dimensions[0]; i++) {
+                uint16_t val = (uint16_t)((this->get_value(i, j, k) - min) / ival * 65536);
+                byteswap = (val>>8) | (val<<8);
+                out.write((char*)&byteswap, sizeof(uint16_t));
+            }
+        }
     }
 
     out.close();
@@ -123,11 +186,8 @@ void ScalarField::save_to_df3(const std::string& filename) {
 
 /* set a value in the grid by specifying its grid location */
 void ScalarField::set_value(unsigned int i, unsigned int j, unsigned int k, double _value) {
-    this->gridptr[this->get_idx(i, j, k)] = _value;
-}
-
-unsigned int ScalarField::get_idx(unsigned int i, unsigned int j, unsigned int k) const {
-    return k * this->gridsize * this->gridsize + j * this->gridsize + i;
+    this->storage.set(i, j, k, _value);
+    this->bricks.reset();
 }
 
 /*
@@ -224,11 +284,7 @@ void ScalarField::calculate_inverse() {
  *
  */
 double ScalarField::get_value(unsigned int i, unsigned int j, unsigned int k) const {
-    unsigned int idx = k * this->grid_dimensions[0] * this->grid_dimensions[1] +
-                       j * this->grid_dimensions[0] +
-                       i;
-
-    return this->gridptr[idx];
+    return this->storage.get(i, j, k);
 }
 
 /*
@@ -292,7 +348,6 @@ void ScalarField::copy_grid_dimensions(unsigned int _grid_dimensions[]) const {
 }
 
 void ScalarField::init() {
-    this->gridptr.resize(this->gridsize * this->gridsize * this->gridsize, 0.0);
     this->grid_dimensions[0] = this->gridsize;
     this->grid_dimensions[1] = this->gridsize;
     this->grid_dimensions[2] = this->gridsize;
@@ -30,10 +30,14 @@
 #include <fstream>
 #include <math.h>
 #include <algorithm>
+#include <memory>
 
 #include <glm/glm.hpp>
 
 #include "wavefunction.h"
+#include "grid_evaluator.h"
+#include "grid_storage.h"
+#include "minmax_bricks.h"
 
 class ScalarField{
 private:
@@ -43,17 +47,50 @@ private:
     glm::mat3 imat33;               //!< glm version of the inverse matrix
 
     unsigned int grid_dimensions[3];
-    std::vector<double> gridptr;    //!< grid to first pos of double array
 
     unsigned int gridsize;
     double resolution;
 
+    GridStorage storage;            //!< values at the grid points
+
+    std::shared_ptr<const GridEvaluator> evaluator;     //!< analytic source of the field, if any
+    glm::dvec3 origin;                                  //!< position of the analytic source's origin
+
+    std::shared_ptr<const MinMaxBricks> bricks;         //!< value ranges of bricks of cells, if built
+
 public:
 
-    ScalarField(unsigned int _gridsize, double _resolution);
+    /**
+     * @brief      Construct a zero-valued cubic scalar field
+     *
+     * @param[in]  _gridsize    Number of grid points along each axis
+     * @param[in]  _resolution  Distance between two grid points
+     * @param[in]  _precision   Precision of the stored values
+     * @param[in]  _layout      Layout of the stored values
+     */
+    ScalarField(unsigned int _gridsize, double _resolution,
+                GridStorage::Precision _precision = GridStorage::Precision::DOUBLE,
+                GridStorage::Layout _layout = GridStorage::Layout::LINEAR);
 
     void load_wavefunction(const WaveFunction &wf, bool sgnd = false);
 
+    /**
+     * @brief      Build the hierarchy of value ranges of bricks of cells,
+     *             used to skip empty regions during isosurface extraction
+     *
+     * @param[in]  brick_size  Number of cells along each edge of a brick
+     */
+    void build_bricks(unsigned int brick_size = 8);
+
+    /**
+     * @brief      Get the hierarchy of value ranges of bricks of cells
+     *
+     * @return     The bricks or nullptr when these have not been built
+     */
+    inline const MinMaxBricks* get_bricks() const {
+        return this->bricks.get();
+    }
+
     /*
      * double get_value_interp(x,y,z)
      *
@@ -88,6 +125,24 @@ public:
 
     double get_value(unsigned int i, unsigned int j, unsigned int k) const;
 
+    /**
+     * @brief      Whether the field stems from an analytic source whose
+     *             gradient can be evaluated exactly
+     *
+     * @return     True if an analytic gradient is available
+     */
+    inline bool has_analytic_gradient() const {
+        return (bool)this->evaluator;
+    }
+
+    /**
+     * @brief      Evaluate the analytic gradient at a set of points
+     *
+     * @param[in]  points     Real-space positions
+     * @param      gradients  Gradients at the positions
+     */
+    void calculate_gradients(const std::vector<glm::vec3>& points, std::vector<glm::vec3>& gradients) const;
+
     glm::dvec3 grid_to_realspace(double i, double j, double k) const;
 
     glm::dvec3 realspace_to_grid(double i, double j, double k) const;
@@ -104,19 +159,17 @@ public:
         return this->imat33;
     }
 
-    inline auto* get_grid_ptr() const {
-        return &this->gridptr[0];
+    inline const GridStorage* get_grid_ptr() const {
+        return &this->storage;
     }
 
     unsigned int get_size() const {
-        return this->gridptr.size();
+        return this->storage.get_nr_points();
     }
 
 private:
     void calculate_inverse();
 
-    unsigned int get_idx(unsigned int i, unsigned int j, unsigned int k) const;
-
     void set_value(unsigned int i, unsigned int j, unsigned int k, double _value);
 
     void init();
@@ -46,6 +46,11 @@ WaveFunction::WaveFunction(int _n, int _l, int _m) {
     this->n = _n;
     this->l = _l;
     this->m = _m;
+
+    this->radial_prefactor = sqrt(pow(2.0 / (double)n, 3.0) * (double)factorial(n - l - 1) /
+                                  ( 2.0 * (double)n * (double)factorial(n + l)));
+    this->polar_prefactor = sqrt((double)(2 * l + 1) * (double)factorial(l - std::abs(m)) /
+                                 (double)factorial(l + std::abs(m)));
 }
 
 double WaveFunction::value(double r, double theta, double phi) const {
@@ -83,11 +88,9 @@ double WaveFunction::polar_density(double theta) const {
  */
 
 double WaveFunction::radial_function(double r) const {
-    double pre = sqrt(pow(2.0 / (double)n, 3.0) * (double)factorial(n - l - 1) /
-                     ( 2.0 * (double)n * (double)factorial(n + l)));
     double rho = 2.0 * r / (double)n;
 
-    return pre * exp(-rho / 2.0) * pow(rho, (double)l) *
+    return this->radial_prefactor * exp(-rho / 2.0) * pow(rho, (double)l) *
                  laguerre_l(n-l-1, 2*l+1, rho);
 }
 
@@ -99,10 +102,7 @@ double WaveFunction::radial_function(double r) const {
  * @return polar part of the wave function evaluated at angle theta
  */
 double WaveFunction::polar_function(double theta) const {
-    double pre = sqrt((double)(2 * l + 1) * (double)factorial(l - std::abs(m)) /
-        (double)factorial(l + std::abs(m)));
-
-    return pre * legendre_p(l, std::abs(m), cos(theta));
+    return this->polar_prefactor * legendre_p(l, std::abs(m), cos(theta));
 }
 
 /*
@@ -37,8 +37,33 @@ private:
     // principal, angular and magnetic quantum number
     int n, l, m;
 
+    // normalization constants of the radial and polar parts
+    double radial_prefactor;
+    double polar_prefactor;
+
 public:
     WaveFunction(int _n, int _l, int _m);
+
+    inline int get_n() const {
+        return this->n;
+    }
+
+    inline int get_l() const {
+        return this->l;
+    }
+
+    inline int get_m() const {
+        return this->m;
+    }
+
+    inline double get_radial_prefactor() const {
+        return this->radial_prefactor;
+    }
+
+    inline double get_polar_prefactor() const {
+        return this->polar_prefactor;
+    }
+
     double value(double r, double theta,
                  double phi) const;
 
@@ -0,0 +1,169 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#include "stream_frame_provider.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief StreamFrameProvider constructor, starts parsing the frames
+ * @param _file file holding the compressed payload
+ * @param _file_contents file contents when the file could not be mapped
+ * @param _stream stream positioned at the first frame record
+ * @param _nr_frames number of frames in the file
+ * @param _abof_version ABOF version of the file
+ */
+StreamFrameProvider::StreamFrameProvider(std::unique_ptr<QFile> _file,
+                                         const QByteArray& _file_contents,
+                                         std::unique_ptr<ZstdStream> _stream,
+                                         size_t _nr_frames,
+                                         uint8_t _abof_version) :
+    file(std::move(_file)),
+    file_contents(_file_contents),
+    stream(std::move(_stream)),
+    nr_frames(_nr_frames),
+    abof_version(_abof_version) {
+    this->records.reserve(this->nr_frames);
+    this->bounds.reserve(this->nr_frames);
+    this->parser = std::thread(&StreamFrameProvider::parse, this);
+}
+
+/**
+ * @brief StreamFrameProvider destructor, stops parsing the frames
+ */
+StreamFrameProvider::~StreamFrameProvider() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->cancelled = true;
+    }
+    this->parser.join();
+}
+
+/**
+ * @brief Get the bounding box of a frame, when it has been parsed
+ * @param frame_id frame index
+ * @return smallest and largest coordinates of atoms and vertices
+ */
+std::optional<std::array<float, 6>> StreamFrameProvider::get_bounds(size_t frame_id) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if(frame_id >= this->bounds.size()) {
+        return std::nullopt;
+    }
+    return this->bounds[frame_id];
+}
+
+/**
+ * @brief Load a frame, waiting until it has been parsed
+ *
+ * The frame record is retained; the frame is built from a copy of it with a
+ * structure of its own, such that the container can change the precision and
+ * the shared data of the structure and can free it upon eviction. The models
+ * own rendering resources and are hence created on the calling thread.
+ *
+ * @param frame_id frame index
+ * @return frame
+ */
+std::shared_ptr<Frame> StreamFrameProvider::load_frame(size_t frame_id) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->cv_parsed.wait(lock, [this, frame_id] {
+        return frame_id < this->records.size() || this->finished;
+    });
+
+    if(frame_id >= this->records.size()) {
+        if(this->error) {
+            std::rethrow_exception(this->error);
+        }
+        throw std::runtime_error("Invalid frame id: " + std::to_string(frame_id) + "/" + std::to_string(this->nr_frames));
+    }
+
+    ContainerLoader::FrameRecord record = this->records[frame_id];
+    lock.unlock();
+
+    // the element identities and bonds are still shared with the record
+    record.structure = std::make_shared<Structure>(*record.structure);
+
+    return this->loader.build_frame(std::move(record));
+}
+
+/**
+ * @brief Parse all frame records; runs on the parser thread
+ *
+ * The stream and the file are released once all frames have been parsed.
+ */
+void StreamFrameProvider::parse() {
+    try {
+        for(size_t f=0; f<this->nr_frames; f++) {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if(this->cancelled) {
+                    break;
+                }
+            }
+
+            ContainerLoader::FrameRecord record = this->loader.decode_frame_stream(*this->stream, this->abof_version);
+
+            // bounding box of the atoms and vertices, as stored in the index
+            // of seekable files
+            std::array<float, 6> box;
+            std::fill(box.begin(), box.begin() + 3, std::numeric_limits<float>::max());
+            std::fill(box.begin() + 3, box.end(), std::numeric_limits<float>::lowest());
+            auto expand = [&box](float x, float y, float z) {
+                const float p[3] = {x, y, z};
+                for(unsigned int k=0; k<3; k++) {
+                    box[k] = std::min(box[k], p[k]);
+                    box[k+3] = std::max(box[k+3], p[k]);
+                }
+            };
+            for(unsigned int i=0; i<record.structure->get_nr_atoms(); i++) {
+                const QVector3D pos = record.structure->get_position(i);
+                expand(pos[0], pos[1], pos[2]);
+            }
+            for(const auto& model : record.models) {
+                for(const auto& v : model.positions) {
+                    expand(v.x, v.y, v.z);
+                }
+            }
+            if(box[0] > box[3]) {
+                box.fill(0.0f);
+            }
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->records.push_back(std::move(record));
+            this->bounds.push_back(box);
+            this->cv_parsed.notify_all();
+        }
+    } catch(...) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->error = std::current_exception();
+    }
+
+    // the frame records own copies of all data
+    this->stream.reset();
+    this->file->close();
+    this->file_contents.clear();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->finished = true;
+    this->cv_parsed.notify_all();
+}
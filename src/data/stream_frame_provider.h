@@ -0,0 +1,129 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef STREAM_FRAME_PROVIDER_H
+#define STREAM_FRAME_PROVIDER_H
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+
+#include "frame_provider.h"
+#include "container_loader.h"
+#include "zstd_stream.h"
+
+/**
+ * @brief Frame provider parsing the frames of a compressed (version 1 or 2)
+ *        ABOF file on a background thread
+ *
+ * The payload of these files can only be read sequentially. A parser thread
+ * decodes the frame records in order while the payload is being decompressed,
+ * such that the first frame can be shown while the remainder of the file is
+ * still being parsed. Loading a frame that has not been parsed yet waits for
+ * the parser. The frame records are retained, hence frames evicted by the
+ * container can be rebuilt without parsing the file again.
+ */
+class StreamFrameProvider : public FrameProvider
+{
+private:
+    std::unique_ptr<QFile> file;                                    // file holding the compressed payload
+    QByteArray file_contents;                                       // file contents when the file cannot be mapped
+    std::unique_ptr<ZstdStream> stream;                             // positioned at the first frame record
+    size_t nr_frames;
+    uint8_t abof_version;
+    ContainerLoader loader;
+
+    mutable std::mutex mutex;                                       // guards the members below
+    std::condition_variable cv_parsed;                              // signalled for every parsed frame
+    std::vector<ContainerLoader::FrameRecord> records;              // frame records parsed so far
+    std::vector<std::array<float, 6>> bounds;                       // bounding boxes of the parsed frames
+    bool finished = false;                                          // whether the parser has stopped
+    bool cancelled = false;                                         // whether the parser has to stop
+    std::exception_ptr error;                                       // error raised by the parser, if any
+
+    std::thread parser;
+
+public:
+    /**
+     * @brief StreamFrameProvider constructor, starts parsing the frames
+     * @param _file file holding the compressed payload
+     * @param _file_contents file contents when the file could not be mapped
+     * @param _stream stream positioned at the first frame record
+     * @param _nr_frames number of frames in the file
+     * @param _abof_version ABOF version of the file
+     */
+    StreamFrameProvider(std::unique_ptr<QFile> _file,
+                        const QByteArray& _file_contents,
+                        std::unique_ptr<ZstdStream> _stream,
+                        size_t _nr_frames,
+                        uint8_t _abof_version);
+
+    /**
+     * @brief StreamFrameProvider destructor, stops parsing the frames
+     */
+    ~StreamFrameProvider();
+
+    StreamFrameProvider(const StreamFrameProvider&) = delete;
+    StreamFrameProvider& operator=(const StreamFrameProvider&) = delete;
+
+    inline size_t get_nr_frames() const override {
+        return this->nr_frames;
+    }
+
+    /**
+     * @brief Get the bounding box of a frame, when it has been parsed
+     * @param frame_id frame index
+     * @return smallest and largest coordinates of atoms and vertices
+     */
+    std::optional<std::array<float, 6>> get_bounds(size_t frame_id) const override;
+
+    /**
+     * @brief Frames are parsed in order by the parser thread; nothing has
+     *        to be done ahead of their use
+     * @param frame_id frame index
+     */
+    inline void prefetch(size_t /*frame_id*/) override {}
+
+    /**
+     * @brief Load a frame, waiting until it has been parsed
+     * @param frame_id frame index
+     * @return frame
+     */
+    std::shared_ptr<Frame> load_frame(size_t frame_id) override;
+
+private:
+    /**
+     * @brief Parse all frame records; runs on the parser thread
+     */
+    void parse();
+};
+
+#endif // STREAM_FRAME_PROVIDER_H
@@ -21,11 +21,61 @@
 
 #include "structure.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 /**
  * @brief      Constructs a new instance.
  */
-Structure::Structure() {
+Structure::Structure() :
+    topology(std::make_shared<Topology>()),
+    bonds(std::make_shared<const std::vector<BondPair>>()) {
+
+}
+
+/**
+ * @brief      Get specific bond
+ *
+ * @param[in]  idx   The index
+ *
+ * @return     The bond.
+ */
+Bond Structure::get_bond(unsigned int idx) const {
+    const BondPair& pair = (*this->bonds)[idx];
+    Atom atom2 = this->get_atom(pair.atom2);
+
+    // bond across a periodic boundary
+    if(pair.shift[0] != 0 || pair.shift[1] != 0 || pair.shift[2] != 0) {
+        const QVector3D t = pair.shift[0] * this->get_unitcell_vector(0) +
+                            pair.shift[1] * this->get_unitcell_vector(1) +
+                            pair.shift[2] * this->get_unitcell_vector(2);
+        atom2.translate(t[0], t[1], t[2]);
+    }
+
+    return Bond(this->get_atom(pair.atom1), atom2);
+}
+
+/**
+ * @brief      Get the number of bytes occupied by the structure; data
+ *             shared with other structures is not included
+ *
+ * @return     Number of bytes
+ */
+size_t Structure::get_memory_size() const {
+    size_t nbytes = sizeof(Structure) +
+                    this->positions.capacity() * sizeof(float) +
+                    this->half_positions.capacity() * sizeof(qfloat16);
+
+    if(this->topology.use_count() == 1) {
+        nbytes += sizeof(Topology) + this->topology->elements.capacity() * sizeof(unsigned int);
+    }
+
+    if(this->bonds.use_count() == 1) {
+        nbytes += this->bonds->capacity() * sizeof(BondPair);
+    }
 
+    return nbytes;
 }
 
 /**
@@ -37,43 +87,137 @@ Structure::Structure() {
  * @param[in]  z     z coordinate
  */
 void Structure::add_atom(unsigned int atnr, double x, double y, double z) {
-    this->atoms.emplace_back(atnr, x, y, z);
+    this->get_unique_topology().elements.push_back(atnr);
+
+    if(this->precision == Precision::HALF) {
+        this->half_positions.insert(this->half_positions.end(), {qfloat16(x), qfloat16(y), qfloat16(z)});
+    } else {
+        this->positions.insert(this->positions.end(), {(float)x, (float)y, (float)z});
+    }
+}
+
+/**
+ * @brief      Set the storage precision of the atomic positions, converting
+ *             the positions that are stored
+ *
+ * Half precision halves the memory of the positions at the expense of about
+ * three significant digits, which suffices for playing back trajectories.
+ *
+ * @param[in]  _precision  The precision
+ */
+void Structure::set_precision(Precision _precision) {
+    if(_precision == this->precision) {
+        return;
+    }
+
+    if(_precision == Precision::HALF) {
+        this->half_positions.assign(this->positions.begin(), this->positions.end());
+        this->positions = std::vector<float>();
+    } else {
+        this->positions.assign(this->half_positions.begin(), this->half_positions.end());
+        this->half_positions = std::vector<qfloat16>();
+    }
+
+    this->precision = _precision;
+}
+
+/**
+ * @brief      Share the element identities and the bonds with another
+ *             structure, each only when identical
+ *
+ * The bonds are only compared when the element identities are identical,
+ * such that they index the same atoms.
+ *
+ * @param[in]  other  The other structure
+ */
+void Structure::share_topology(const Structure& other) {
+    if(this->topology != other.topology) {
+        if(this->topology->elements != other.topology->elements) {
+            return;
+        }
+        this->topology = other.topology;
+    }
+
+    if(this->bonds != other.bonds && *this->bonds == *other.bonds) {
+        this->bonds = other.bonds;
+    }
+}
+
+/**
+ * @brief      Set the unit cell of the structure
+ *
+ * @param[in]  mat   Unit cell matrix; each row holds a lattice vector
+ */
+void Structure::set_unitcell(const QMatrix3x3& mat) {
+    const double det = mat(0,0) * (mat(1,1) * mat(2,2) - mat(1,2) * mat(2,1)) -
+                       mat(0,1) * (mat(1,0) * mat(2,2) - mat(1,2) * mat(2,0)) +
+                       mat(0,2) * (mat(1,0) * mat(2,1) - mat(1,1) * mat(2,0));
+
+    if(std::fabs(det) < 1e-6) {
+        qWarning() << "Ignoring degenerate unit cell.";
+        return;
+    }
+
+    this->unitcell = mat;
+    this->flag_unitcell = true;
+}
+
+/**
+ * @brief      Get the element identities for modification, copying them first
+ *             when they are shared with another structure
+ *
+ * @return     The element identities
+ */
+Structure::Topology& Structure::get_unique_topology() {
+    if(this->topology.use_count() > 1) {
+        this->topology = std::make_shared<Topology>(*this->topology);
+    }
+    return *this->topology;
+}
+
+/**
+ * @brief      Set the position of an atom
+ *
+ * @param[in]  idx   The index
+ * @param[in]  pos   The position
+ */
+void Structure::set_position(unsigned int idx, const QVector3D& pos) {
+    for(unsigned int k=0; k<3; k++) {
+        if(this->precision == Precision::HALF) {
+            this->half_positions[3*idx+k] = qfloat16(pos[k]);
+        } else {
+            this->positions[3*idx+k] = pos[k];
+        }
+    }
 }
 
 /**
  * @brief      Center the structure at the origin
  */
 void Structure::center() {
+    const unsigned int nr_atoms = this->get_nr_atoms();
     double sumx = 0.0;
     double sumy = 0.0;
     double sumz = 0.0;
 
-    #pragma omp parallel for reduction(+: sumx)
-    for(unsigned int i=0; i<this->atoms.size(); i++) {
-        sumx += this->atoms[i].x;
-    }
-
-    #pragma omp parallel for reduction(+: sumy)
-    for(unsigned int i=0; i<this->atoms.size(); i++) {
-        sumy += this->atoms[i].y;
+    #pragma omp parallel for reduction(+: sumx, sumy, sumz)
+    for(unsigned int i=0; i<nr_atoms; i++) {
+        const QVector3D pos = this->get_position(i);
+        sumx += pos[0];
+        sumy += pos[1];
+        sumz += pos[2];
     }
 
-    #pragma omp parallel for reduction(+: sumz)
-    for(unsigned int i=0; i<this->atoms.size(); i++) {
-        sumz += this->atoms[i].z;
-    }
-
-    sumx /= (float)this->atoms.size();
-    sumy /= (float)this->atoms.size();
-    sumz /= (float)this->atoms.size();
+    sumx /= (float)nr_atoms;
+    sumy /= (float)nr_atoms;
+    sumz /= (float)nr_atoms;
 
     auto cv = get_center_vector();
+    const QVector3D shift(sumx + cv[0], sumy + cv[1], sumz + cv[2]);
 
     #pragma omp parallel for
-    for(unsigned int i=0; i<this->atoms.size(); i++) {
-        this->atoms[i].x -= sumx + cv[0];
-        this->atoms[i].y -= sumy + cv[1];
-        this->atoms[i].z -= sumz + cv[2];
+    for(unsigned int i=0; i<nr_atoms; i++) {
+        this->set_position(i, this->get_position(i) - shift);
     }
 }
 
@@ -84,22 +228,18 @@ void Structure::center() {
  */
 QVector3D Structure::get_largest_distance() const {
     unsigned int idx = 0;
-    float dist;
+    float dist = 0.0f;
 
-    #pragma omp parallel for
-    for(unsigned int i=0; i<this->atoms.size(); i++) {
-        float vdist = this->atoms[i].get_pos_qtvec().lengthSquared();
+    for(unsigned int i=0; i<this->get_nr_atoms(); i++) {
+        float vdist = this->get_position(i).lengthSquared();
 
         if(vdist > dist) {
-            #pragma omp critical
-            {
-                dist = vdist;
-                idx = i;
-            }
+            dist = vdist;
+            idx = i;
         }
     }
 
-    return this->atoms[idx].get_pos_qtvec();
+    return this->get_position(idx);
 }
 
 /**
@@ -110,7 +250,7 @@ QVector3D Structure::get_largest_distance() const {
 std::string Structure::get_elements_string() const {
     std::string result;
 
-    for(const auto& item : this->element_types) {
+    for(const auto& item : this->topology->element_types) {
         result += QString("%1 (%2); ").arg(QString(item.first.c_str())).arg(item.second).toStdString();
     }
 
@@ -127,52 +267,381 @@ std::string Structure::get_elements_string() const {
  * @return     Vector that puts unitcell at the origin
  */
 QVector3D Structure::get_center_vector() const {
-    return QVector3D(0,0,0);
+    if(!this->flag_unitcell) {
+        return QVector3D(0,0,0);
+    }
+
+    return -0.5f * (this->get_unitcell_vector(0) +
+                    this->get_unitcell_vector(1) +
+                    this->get_unitcell_vector(2));
 }
 
 /**
  * @brief      Update data based on contents;
  */
 void Structure::update() {
+    // the structure is complete; release the excess capacity of the
+    // positions, which are held for every frame of a trajectory
+    this->positions.shrink_to_fit();
+    this->half_positions.shrink_to_fit();
+
     this->count_elements();
-    this->construct_bonds();
+
+    std::vector<Atom> atoms;
+    atoms.reserve(this->get_nr_atoms());
+    for(unsigned int i=0; i<this->get_nr_atoms(); i++) {
+        atoms.push_back(this->get_atom(i));
+    }
+    this->construct_bonds(atoms);
 }
 
 /**
  * @brief      Count the number of elements
  */
 void Structure::count_elements() {
-    this->element_types.clear();
+    Topology& topo = this->get_unique_topology();
+    topo.element_types.clear();
 
-    for(const auto& atom : this->atoms) {
-        std::string atomname = AtomSettings::get().get_name_from_elnr(atom.atnr);
-        auto got = this->element_types.find(atomname);
-        if(got != this->element_types.end()) {
+    const AtomSettings& atom_settings = AtomSettings::get();
+    for(unsigned int atnr : topo.elements) {
+        const std::string& atomname = atom_settings.get_name_from_elnr(atnr);
+        auto got = topo.element_types.find(atomname);
+        if(got != topo.element_types.end()) {
             got->second++;
         } else {
-            this->element_types.emplace(atomname, 1);
+            topo.element_types.emplace(atomname, 1);
         }
     }
 }
 
 /**
  * @brief      Construct the bonds
+ *
+ * Bonds are detected using a cell list: the bounding box of the structure
+ * is divided into cells with an edge length of at least the largest bond
+ * cutoff, such that bonded atoms are always found in the same or in one of
+ * the 26 adjacent cells. The cells are processed in parallel and the
+ * resulting atom pairs are sorted afterwards, such that the bonds are
+ * stored in the same order as an all-pairs search would produce.
+ *
+ * @param[in]  atoms  The atoms of the structure
  */
-void Structure::construct_bonds() {
-    this->bonds.clear();
+void Structure::construct_bonds(const std::vector<Atom>& atoms) {
+    if(this->flag_unitcell) {
+        this->construct_bonds_periodic(atoms);
+        return;
+    }
+
+    const unsigned int nr_atoms = atoms.size();
+    if(nr_atoms < 2) {
+        this->bonds = std::make_shared<const std::vector<BondPair>>();
+        return;
+    }
+
+    const AtomSettings& atom_settings = AtomSettings::get();
+
+    // determine bounding box of the structure
+    double minp[3] = {atoms[0].x, atoms[0].y, atoms[0].z};
+    double maxp[3] = {atoms[0].x, atoms[0].y, atoms[0].z};
+    for(const auto& atom : atoms) {
+        const double pos[3] = {atom.x, atom.y, atom.z};
+        for(unsigned int k=0; k<3; k++) {
+            minp[k] = std::min(minp[k], pos[k]);
+            maxp[k] = std::max(maxp[k], pos[k]);
+        }
+    }
+
+    // determine cell size; the cells are enlarged for very sparse
+    // structures to keep the number of cells proportional to the number
+    // of atoms
+    double cell_size = std::max(atom_settings.get_max_bond_distance(), 1e-3);
+    unsigned int dims[3];
+    const size_t max_cells = std::max<size_t>(8 * nr_atoms, 27);
+    while(true) {
+        for(unsigned int k=0; k<3; k++) {
+            dims[k] = (unsigned int)std::floor((maxp[k] - minp[k]) / cell_size) + 1;
+        }
+        if((size_t)dims[0] * dims[1] * dims[2] <= max_cells) {
+            break;
+        }
+        cell_size *= 2.0;
+    }
+    const unsigned int nr_cells = dims[0] * dims[1] * dims[2];
+
+    // assign atoms to cells using a counting sort; atoms within a cell
+    // remain sorted by their index
+    std::vector<unsigned int> atom_cell(nr_atoms);
+    std::vector<unsigned int> cell_start(nr_cells + 1, 0);
+    for(unsigned int i=0; i<nr_atoms; i++) {
+        const auto& atom = atoms[i];
+        const unsigned int cx = std::min((unsigned int)((atom.x - minp[0]) / cell_size), dims[0] - 1);
+        const unsigned int cy = std::min((unsigned int)((atom.y - minp[1]) / cell_size), dims[1] - 1);
+        const unsigned int cz = std::min((unsigned int)((atom.z - minp[2]) / cell_size), dims[2] - 1);
+        atom_cell[i] = (cz * dims[1] + cy) * dims[0] + cx;
+        cell_start[atom_cell[i] + 1]++;
+    }
+    for(unsigned int c=0; c<nr_cells; c++) {
+        cell_start[c+1] += cell_start[c];
+    }
+    std::vector<unsigned int> cell_atoms(nr_atoms);
+    {
+        std::vector<unsigned int> fill(cell_start.begin(), cell_start.end() - 1);
+        for(unsigned int i=0; i<nr_atoms; i++) {
+            cell_atoms[fill[atom_cell[i]]++] = i;
+        }
+    }
+
+    // search for bonded pairs, each cell collects its own pairs
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> cell_pairs(nr_cells);
 
-    for(unsigned int i=0; i<this->atoms.size(); i++) {
-        const auto& atom1 = this->atoms[i];
-        for(unsigned int j=i+1; j<this->atoms.size(); j++) {
-            const auto& atom2 = this->atoms[j];
-            double maxdist2 = AtomSettings::get().get_bond_distance(atom1.atnr, atom2.atnr);
+    #pragma omp parallel for schedule(dynamic)
+    for(int c=0; c<(int)nr_cells; c++) {
+        if(cell_start[c] == cell_start[c+1]) {
+            continue;
+        }
+
+        const int cx = c % dims[0];
+        const int cy = (c / dims[0]) % dims[1];
+        const int cz = c / (dims[0] * dims[1]);
+
+        for(unsigned int a=cell_start[c]; a<cell_start[c+1]; a++) {
+            const unsigned int i = cell_atoms[a];
+            const Atom& atom1 = atoms[i];
+
+            for(int dz=-1; dz<=1; dz++) {
+                const int nz = cz + dz;
+                if(nz < 0 || nz >= (int)dims[2]) continue;
+                for(int dy=-1; dy<=1; dy++) {
+                    const int ny = cy + dy;
+                    if(ny < 0 || ny >= (int)dims[1]) continue;
+                    for(int dx=-1; dx<=1; dx++) {
+                        const int nx = cx + dx;
+                        if(nx < 0 || nx >= (int)dims[0]) continue;
+
+                        const unsigned int nc = (nz * dims[1] + ny) * dims[0] + nx;
+                        for(unsigned int b=cell_start[nc]; b<cell_start[nc+1]; b++) {
+                            const unsigned int j = cell_atoms[b];
+                            if(j <= i) {
+                                continue;
+                            }
 
-            double dist2 = atom1.dist(atom2);
+                            const Atom& atom2 = atoms[j];
+                            const double maxdist = atom_settings.get_bond_distance(atom1.atnr, atom2.atnr);
 
-            // check if atoms are bonded
-            if(dist2 < maxdist2) {
-                this->bonds.emplace_back(atom1, atom2);
+                            // check if atoms are bonded
+                            if(atom1.dist2(atom2) < maxdist * maxdist) {
+                                cell_pairs[c].emplace_back(i, j);
+                            }
+                        }
+                    }
+                }
             }
         }
     }
+
+    // merge and sort the pairs
+    std::vector<std::pair<unsigned int, unsigned int>> pairs;
+    for(const auto& p : cell_pairs) {
+        pairs.insert(pairs.end(), p.begin(), p.end());
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    auto bond_pairs = std::make_shared<std::vector<BondPair>>();
+    bond_pairs->reserve(pairs.size());
+    for(const auto& p : pairs) {
+        bond_pairs->push_back({p.first, p.second, {0, 0, 0}});
+    }
+    this->bonds = std::move(bond_pairs);
+}
+
+/**
+ * @brief      Construct the bonds using the minimum image convention of the
+ *             unit cell
+ *
+ * The atoms are binned on their (wrapped) fractional coordinates, such that
+ * neighbouring bins across the cell boundaries are found by wrapping the bin
+ * index; the number of wraps gives the lattice translation of the image.
+ * Every bond is stored once, together with the lattice translation of its
+ * second atom; the renderer draws a bond across a periodic boundary as the
+ * half at each of its two atoms.
+ *
+ * @param[in]  atoms  The atoms of the structure
+ */
+void Structure::construct_bonds_periodic(const std::vector<Atom>& atoms) {
+    const unsigned int nr_atoms = atoms.size();
+    if(nr_atoms == 0) {
+        this->bonds = std::make_shared<const std::vector<BondPair>>();
+        return;
+    }
+
+    const AtomSettings& atom_settings = AtomSettings::get();
+    const double cutoff = std::max(atom_settings.get_max_bond_distance(), 1e-3);
+
+    // lattice vectors (rows of the unit cell matrix)
+    double lat[3][3];
+    for(unsigned int i=0; i<3; i++) {
+        for(unsigned int j=0; j<3; j++) {
+            lat[i][j] = this->unitcell(i,j);
+        }
+    }
+
+    // reciprocal vectors without the factor 2pi; the fractional coordinate
+    // along lattice vector k is given by the dot product with rec[k]
+    auto cross = [](const double* u, const double* v, double* w) {
+        w[0] = u[1] * v[2] - u[2] * v[1];
+        w[1] = u[2] * v[0] - u[0] * v[2];
+        w[2] = u[0] * v[1] - u[1] * v[0];
+    };
+    double rec[3][3];
+    cross(lat[1], lat[2], rec[0]);
+    cross(lat[2], lat[0], rec[1]);
+    cross(lat[0], lat[1], rec[2]);
+    const double volume = lat[0][0] * rec[0][0] + lat[0][1] * rec[0][1] + lat[0][2] * rec[0][2];
+
+    // determine the number of bins along each lattice vector such that each
+    // bin is at least as wide as the cutoff, and the number of neighbouring
+    // bins that has to be searched in each direction
+    int nbins[3];
+    int range[3];
+    for(unsigned int k=0; k<3; k++) {
+        for(unsigned int j=0; j<3; j++) {
+            rec[k][j] /= volume;
+        }
+        const double width = 1.0 / std::sqrt(rec[k][0] * rec[k][0] + rec[k][1] * rec[k][1] + rec[k][2] * rec[k][2]);
+        nbins[k] = std::max(1, (int)std::floor(width / cutoff));
+    }
+    const size_t max_bins = std::max<size_t>(8 * nr_atoms, 27);
+    while((size_t)nbins[0] * nbins[1] * nbins[2] > max_bins) {
+        for(unsigned int k=0; k<3; k++) {
+            nbins[k] = std::max(1, nbins[k] / 2);
+        }
+    }
+    for(unsigned int k=0; k<3; k++) {
+        const double width = 1.0 / std::sqrt(rec[k][0] * rec[k][0] + rec[k][1] * rec[k][1] + rec[k][2] * rec[k][2]);
+        range[k] = (int)std::ceil(cutoff * nbins[k] / width);
+    }
+    const unsigned int nr_bins = nbins[0] * nbins[1] * nbins[2];
+
+    // wrap the atoms into the unit cell; the wrapped cartesian positions are
+    // stored together with the lattice translation that was applied
+    std::vector<std::array<double,3>> wrapped(nr_atoms);
+    std::vector<std::array<int,3>> wraps(nr_atoms);
+    std::vector<unsigned int> atom_bin(nr_atoms);
+    std::vector<unsigned int> bin_start(nr_bins + 1, 0);
+    for(unsigned int i=0; i<nr_atoms; i++) {
+        const double pos[3] = {atoms[i].x, atoms[i].y, atoms[i].z};
+        int bin[3];
+        for(unsigned int k=0; k<3; k++) {
+            const double frac = pos[0] * rec[k][0] + pos[1] * rec[k][1] + pos[2] * rec[k][2];
+            wraps[i][k] = (int)std::floor(frac);
+            bin[k] = std::min((int)((frac - wraps[i][k]) * nbins[k]), nbins[k] - 1);
+        }
+        for(unsigned int j=0; j<3; j++) {
+            wrapped[i][j] = pos[j] - wraps[i][0] * lat[0][j] - wraps[i][1] * lat[1][j] - wraps[i][2] * lat[2][j];
+        }
+        atom_bin[i] = (bin[2] * nbins[1] + bin[1]) * nbins[0] + bin[0];
+        bin_start[atom_bin[i] + 1]++;
+    }
+    for(unsigned int b=0; b<nr_bins; b++) {
+        bin_start[b+1] += bin_start[b];
+    }
+    std::vector<unsigned int> bin_atoms(nr_atoms);
+    {
+        std::vector<unsigned int> fill(bin_start.begin(), bin_start.end() - 1);
+        for(unsigned int i=0; i<nr_atoms; i++) {
+            bin_atoms[fill[atom_bin[i]]++] = i;
+        }
+    }
+
+    // a bonded pair: atom i is bonded to the image of atom j that is
+    // translated by the lattice vector shift
+    struct PeriodicPair {
+        unsigned int i;
+        unsigned int j;
+        std::array<int,3> shift;
+
+        bool operator<(const PeriodicPair& other) const {
+            if(this->i != other.i) return this->i < other.i;
+            if(this->j != other.j) return this->j < other.j;
+            return this->shift < other.shift;
+        }
+    };
+
+    // search for bonded pairs, each bin collects its own pairs
+    std::vector<std::vector<PeriodicPair>> bin_pairs(nr_bins);
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int c=0; c<(int)nr_bins; c++) {
+        const int cbin[3] = {c % nbins[0], (c / nbins[0]) % nbins[1], c / (nbins[0] * nbins[1])};
+
+        for(unsigned int a=bin_start[c]; a<bin_start[c+1]; a++) {
+            const unsigned int i = bin_atoms[a];
+
+            int d[3];
+            for(d[2]=-range[2]; d[2]<=range[2]; d[2]++) {
+            for(d[1]=-range[1]; d[1]<=range[1]; d[1]++) {
+            for(d[0]=-range[0]; d[0]<=range[0]; d[0]++) {
+                // wrap the neighbouring bin back into the unit cell and keep
+                // track of the number of periods that were crossed
+                int nbin[3];
+                int period[3];
+                for(unsigned int k=0; k<3; k++) {
+                    const int idx = cbin[k] + d[k];
+                    period[k] = (int)std::floor((double)idx / nbins[k]);
+                    nbin[k] = idx - period[k] * nbins[k];
+                }
+                const unsigned int nc = (nbin[2] * nbins[1] + nbin[1]) * nbins[0] + nbin[0];
+
+                double offset[3];
+                for(unsigned int j=0; j<3; j++) {
+                    offset[j] = period[0] * lat[0][j] + period[1] * lat[1][j] + period[2] * lat[2][j];
+                }
+
+                for(unsigned int b=bin_start[nc]; b<bin_start[nc+1]; b++) {
+                    const unsigned int j = bin_atoms[b];
+
+                    // lattice translation of atom j with respect to its
+                    // original (unwrapped) position
+                    std::array<int,3> shift;
+                    for(unsigned int k=0; k<3; k++) {
+                        shift[k] = period[k] + wraps[i][k] - wraps[j][k];
+                    }
+
+                    // every pair is found from both sides; only keep one
+                    const bool zero_shift = shift[0] == 0 && shift[1] == 0 && shift[2] == 0;
+                    if(j < i || (j == i && (zero_shift || shift < std::array<int,3>{0,0,0}))) {
+                        continue;
+                    }
+
+                    double dist2 = 0.0;
+                    for(unsigned int k=0; k<3; k++) {
+                        const double dx = wrapped[j][k] + offset[k] - wrapped[i][k];
+                        dist2 += dx * dx;
+                    }
+
+                    const double maxdist = atom_settings.get_bond_distance(atoms[i].atnr, atoms[j].atnr);
+                    if(dist2 < maxdist * maxdist) {
+                        bin_pairs[c].push_back({i, j, shift});
+                    }
+                }
+            }
+            }
+            }
+        }
+    }
+
+    // merge and sort the pairs
+    std::vector<PeriodicPair> pairs;
+    for(const auto& p : bin_pairs) {
+        pairs.insert(pairs.end(), p.begin(), p.end());
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    // every bond is stored once, also when it crosses a periodic boundary
+    auto bond_pairs = std::make_shared<std::vector<BondPair>>();
+    bond_pairs->reserve(pairs.size());
+    for(const auto& p : pairs) {
+        bond_pairs->push_back({p.i, p.j, {(int16_t)p.shift[0], (int16_t)p.shift[1], (int16_t)p.shift[2]}});
+    }
+    this->bonds = std::move(bond_pairs);
 }
@@ -25,6 +25,11 @@
 #include <QVector3D>
 #include <QMatrix4x4>
 #include <QGenericMatrix>
+#include <QFloat16>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <QString>
 
@@ -32,16 +37,56 @@
 #include "atom.h"
 #include "bond.h"
 
+/**
+ * @brief      Pair of bonded atoms
+ *
+ * For a bond across a periodic boundary, the second atom is translated by
+ * the lattice vectors given by the shift.
+ */
+struct BondPair {
+    uint32_t atom1;
+    uint32_t atom2;
+    std::array<int16_t,3> shift;
+
+    inline bool operator==(const BondPair& other) const {
+        return this->atom1 == other.atom1 && this->atom2 == other.atom2 && this->shift == other.shift;
+    }
+};
+
 /**
  * @brief      This class describes a chemical structure.
+ *
+ * Only the positions of the atoms belong to a single structure. The element
+ * identities and the bonds are held by reference, such that the frames of a
+ * trajectory can share them (see share_topology()). Atoms and bonds are
+ * hence returned by value and assembled on access.
  */
 class Structure {
+public:
+    /**
+     * @brief      Storage precision of the atomic positions
+     */
+    enum class Precision {
+        FLOAT,
+        HALF
+    };
 
 private:
-    std::vector<Atom> atoms;            // atoms in the structure
-    std::vector<Bond> bonds;            // bonds between the atoms
-    std::vector<double> radii;          // radii of the atoms
-    std::unordered_map<std::string, unsigned int> element_types;    // elements present in the structure
+    /**
+     * @brief      Element identities of the atoms
+     */
+    struct Topology {
+        std::vector<unsigned int> elements;                             // element of every atom
+        std::unordered_map<std::string, unsigned int> element_types;    // elements present in the structure
+    };
+
+    std::shared_ptr<Topology> topology;                 // element identities; copied before being modified when shared
+    std::shared_ptr<const std::vector<BondPair>> bonds; // bonds between the atoms
+    std::vector<float> positions;                       // x,y,z of every atom in FLOAT precision
+    std::vector<qfloat16> half_positions;               // x,y,z of every atom in HALF precision
+    Precision precision = Precision::FLOAT;
+    QMatrix3x3 unitcell;                // unit cell matrix, rows hold the lattice vectors
+    bool flag_unitcell = false;         // whether the structure is periodic
 
 public:
     /**
@@ -50,21 +95,28 @@ public:
     Structure();
 
     /**
-     * @brief      Get all atoms from the structure
+     * @brief      Get the element of an atom
+     *
+     * @param[in]  idx   The index
      *
-     * @return     The atoms.
+     * @return     The element number.
      */
-    inline const auto& get_atoms() const {
-        return this->atoms;
+    inline unsigned int get_element(unsigned int idx) const {
+        return this->topology->elements[idx];
     }
 
     /**
-     * @brief      Get all bonds from the structure
+     * @brief      Get the position of an atom
+     *
+     * @param[in]  idx   The index
      *
-     * @return     The atoms.
+     * @return     The position.
      */
-    inline const auto& get_bonds() const {
-        return this->bonds;
+    inline QVector3D get_position(unsigned int idx) const {
+        if(this->precision == Precision::HALF) {
+            return QVector3D(this->half_positions[3*idx], this->half_positions[3*idx+1], this->half_positions[3*idx+2]);
+        }
+        return QVector3D(this->positions[3*idx], this->positions[3*idx+1], this->positions[3*idx+2]);
     }
 
     /**
@@ -74,32 +126,42 @@ public:
      *
      * @return     The atom.
      */
-    inline const Atom& get_atom(unsigned int idx) const {
-        return this->atoms[idx];
+    inline Atom get_atom(unsigned int idx) const {
+        const QVector3D pos = this->get_position(idx);
+        return Atom(this->get_element(idx), pos[0], pos[1], pos[2]);
     }
 
     /**
      * @brief      Get specific bond
      *
+     * For a bond across a periodic boundary, the second atom is the image
+     * bonded to the first atom, which may lie outside of the unit cell.
+     *
      * @param[in]  idx   The index
      *
      * @return     The bond.
      */
-    inline const Bond& get_bond(unsigned int idx) const {
-        return this->bonds[idx];
-    }
+    Bond get_bond(unsigned int idx) const;
 
     /**
-     * @brief      Gets the atomic radius.
+     * @brief      Get the atom indices and lattice shift of a bond
      *
      * @param[in]  idx   The index
      *
-     * @return     The radius.
+     * @return     The bonded pair.
      */
-    inline double get_radius(unsigned int idx) const {
-        return this->radii[idx];
+    inline const BondPair& get_bond_pair(unsigned int idx) const {
+        return (*this->bonds)[idx];
     }
 
+    /**
+     * @brief      Get the number of bytes occupied by the structure; data
+     *             shared with other structures is not included
+     *
+     * @return     Number of bytes
+     */
+    size_t get_memory_size() const;
+
     /**
      * @brief      Add an atom to the structure
      *
@@ -116,7 +178,7 @@ public:
      * @return     The number of atoms
      */
     inline size_t get_nr_atoms() const {
-        return this->atoms.size();
+        return this->topology->elements.size();
     }
 
     /**
@@ -125,13 +187,73 @@ public:
      * @return     The number of bonds
      */
     inline size_t get_nr_bonds() const {
-        return this->bonds.size();
+        return this->bonds->size();
+    }
+
+    /**
+     * @brief      Set the storage precision of the atomic positions,
+     *             converting the positions that are stored
+     *
+     * @param[in]  _precision  The precision
+     */
+    void set_precision(Precision _precision);
+
+    inline Precision get_precision() const {
+        return this->precision;
+    }
+
+    /**
+     * @brief      Share the element identities and the bonds with another
+     *             structure, each only when identical
+     *
+     * @param[in]  other  The other structure
+     */
+    void share_topology(const Structure& other);
+
+    /**
+     * @brief      Set the unit cell of the structure
+     *
+     * Setting a unit cell marks the structure as periodic. The unit cell
+     * has to be set before calling update() such that bonds across the
+     * periodic boundaries are detected. A degenerate unit cell is ignored.
+     *
+     * @param[in]  mat   Unit cell matrix; each row holds a lattice vector
+     */
+    void set_unitcell(const QMatrix3x3& mat);
+
+    /**
+     * @brief      Whether the structure has a unit cell
+     *
+     * @return     True if periodic
+     */
+    inline bool has_unitcell() const {
+        return this->flag_unitcell;
+    }
+
+    /**
+     * @brief      Get the unit cell matrix
+     *
+     * @return     Unit cell matrix; each row holds a lattice vector
+     */
+    inline const QMatrix3x3& get_unitcell() const {
+        return this->unitcell;
+    }
+
+    /**
+     * @brief      Get a lattice vector of the unit cell
+     *
+     * @param[in]  idx   Index of the lattice vector (0-2)
+     *
+     * @return     The lattice vector
+     */
+    inline QVector3D get_unitcell_vector(unsigned int idx) const {
+        return QVector3D(this->unitcell(idx,0), this->unitcell(idx,1), this->unitcell(idx,2));
     }
 
     ~Structure() {
         qDebug() << "Deleting structure ("
                  << QString("0x%1").arg((size_t)this, 0, 16)
-                 << "; " << this->atoms.size() << " atoms ).";
+                 << "; " << this->get_nr_atoms() << " atoms ).";
     }
 
     //********************************************
@@ -177,6 +299,22 @@ public:
     void select_atom(unsigned int idx);
 
 private:
+    /**
+     * @brief      Get the element identities for modification, copying them
+     *             first when they are shared with another structure
+     *
+     * @return     The element identities
+     */
+    Topology& get_unique_topology();
+
+    /**
+     * @brief      Set the position of an atom
+     *
+     * @param[in]  idx   The index
+     * @param[in]  pos   The position
+     */
+    void set_position(unsigned int idx, const QVector3D& pos);
+
     /**
      * @brief      Count the number of elements
      */
@@ -184,6 +322,16 @@ private:
 
     /**
      * @brief      Construct the bonds
+     *
+     * @param[in]  atoms  The atoms of the structure
+     */
+    void construct_bonds(const std::vector<Atom>& atoms);
+
+    /**
+     * @brief      Construct the bonds using the minimum image convention
+     *             of the unit cell
+     *
+     * @param[in]  atoms  The atoms of the structure
      */
-    void construct_bonds();
+    void construct_bonds_periodic(const std::vector<Atom>& atoms);
 };
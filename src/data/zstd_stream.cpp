@@ -0,0 +1,212 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#include "zstd_stream.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <zstd.h>
+
+/**
+ * @brief ZstdStream constructor, starts the decompression
+ * @param data first compressed byte
+ * @param size number of compressed bytes
+ * @param source name of the source of the bytes
+ * @param capacity size of the ring buffer in bytes
+ */
+ZstdStream::ZstdStream(const char* _data, size_t _size, const std::string& _source, size_t capacity) :
+    src(_data),
+    src_size(_size),
+    source(_source),
+    ring(std::max(capacity, ZSTD_DStreamOutSize())) {
+    this->worker = std::thread(&ZstdStream::decompress, this);
+}
+
+/**
+ * @brief ZstdStream destructor, stops the decompression
+ */
+ZstdStream::~ZstdStream() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->cancelled = true;
+    }
+    this->cv_space.notify_all();
+    this->worker.join();
+}
+
+/**
+ * @brief Get access to a number of bytes and advance the stream, waiting
+ *        until these have been decompressed
+ * @param nbytes number of bytes
+ * @return pointer to the first byte
+ */
+const char* ZstdStream::view(size_t nbytes) {
+    this->release();
+
+    const size_t capacity = this->ring.size();
+    const size_t offset = this->consumed % capacity;
+
+    // hand out the bytes in place when they do not wrap around the ring
+    if(nbytes <= capacity - offset) {
+        this->wait_for_data(nbytes);
+        this->pending = nbytes;
+        return this->ring.data() + offset;
+    }
+
+    // otherwise gather them piecewise, releasing the ring as we go
+    this->scratch.resize(nbytes);
+    size_t copied = 0;
+    while(copied < nbytes) {
+        const size_t available = this->wait_for_data(1);
+        const size_t start = this->consumed % capacity;
+        const size_t chunk = std::min({available, capacity - start, nbytes - copied});
+        std::memcpy(this->scratch.data() + copied, this->ring.data() + start, chunk);
+        copied += chunk;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->consumed += chunk;
+        }
+        this->cv_space.notify_one();
+    }
+
+    return this->scratch.data();
+}
+
+/**
+ * @brief Get access to an array of fixed-size records and advance the
+ *        stream
+ * @param count number of records
+ * @param record_size number of bytes per record
+ * @return pointer to the first byte
+ */
+const char* ZstdStream::view(size_t count, size_t record_size) {
+    if(record_size != 0 && count > std::numeric_limits<size_t>::max() / record_size) {
+        throw std::runtime_error("Corrupt ABO file (unexpected EOF): " + this->source);
+    }
+    return this->view(count * record_size);
+}
+
+/**
+ * @brief Decompress all bytes into the ring buffer; runs on the worker
+ *        thread
+ */
+void ZstdStream::decompress() {
+    ZSTD_DStream* dstream = ZSTD_createDStream();
+
+    try {
+        if (!dstream)
+            throw std::runtime_error("Failed to allocate zstd decompressor");
+        size_t init_result = ZSTD_initDStream(dstream);
+        if (ZSTD_isError(init_result))
+            throw std::runtime_error(
+                std::string("Failed to init zstd decompressor: ") +
+                ZSTD_getErrorName(init_result));
+
+        const size_t capacity = this->ring.size();
+        ZSTD_inBuffer input{this->src, this->src_size, 0};
+        while(true) {
+            // wait for free space in the ring
+            size_t offset = 0;
+            size_t space = 0;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->cv_space.wait(lock, [&] {
+                    return this->cancelled || this->produced - this->consumed < capacity;
+                });
+                if(this->cancelled) {
+                    break;
+                }
+                offset = this->produced % capacity;
+                space = std::min(capacity - offset, capacity - (this->produced - this->consumed));
+            }
+
+            ZSTD_outBuffer output{this->ring.data() + offset, space, 0};
+            size_t const ret = ZSTD_decompressStream(dstream, &output, &input);
+            if (ZSTD_isError(ret))
+                throw std::runtime_error(
+                    std::string("Failed to stream-decompress ABO payload: ") +
+                    ZSTD_getErrorName(ret));
+
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->produced += output.pos;
+            }
+            this->cv_data.notify_one();
+
+            // all input is consumed and no more output is pending
+            if (input.pos == input.size && (ret == 0 || output.pos < output.size)) {
+                if (ret != 0)
+                    throw std::runtime_error("Corrupt ABO file (truncated zstd payload): " + this->source);
+                break;
+            }
+        }
+    } catch(...) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->error = std::current_exception();
+    }
+
+    ZSTD_freeDStream(dstream);
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->finished = true;
+    }
+    this->cv_data.notify_one();
+}
+
+/**
+ * @brief Release the bytes handed out by the last view
+ */
+void ZstdStream::release() {
+    if(this->pending == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->consumed += this->pending;
+        this->pending = 0;
+    }
+    this->cv_space.notify_one();
+}
+
+/**
+ * @brief Wait until a number of bytes is available to the reader
+ * @param nbytes number of bytes
+ * @return number of available bytes
+ */
+size_t ZstdStream::wait_for_data(size_t nbytes) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->cv_data.wait(lock, [&] {
+        return this->produced - this->consumed >= nbytes || this->finished;
+    });
+
+    const size_t available = this->produced - this->consumed;
+    if(available < nbytes) {
+        if(this->error) {
+            std::rethrow_exception(this->error);
+        }
+        throw std::runtime_error("Corrupt ABO file (unexpected EOF): " + this->source);
+    }
+
+    return available;
+}
@@ -0,0 +1,144 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef ZSTD_STREAM_H
+#define ZSTD_STREAM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Sequential reader over a zstd-compressed block of bytes
+ *
+ * A worker thread decompresses the bytes into a ring buffer while the reader
+ * consumes them, such that parsing starts as soon as the first bytes are
+ * available and the decompressed payload never resides in memory as a whole.
+ * The reader offers the same interface as ByteCursor. Pointers returned by
+ * view() remain valid until the next read.
+ */
+class ZstdStream
+{
+private:
+    const char* src;            // compressed bytes; these have to outlive the stream
+    size_t src_size;
+    std::string source;         // name of the source of the bytes, used in error messages
+
+    std::vector<char> ring;     // decompressed bytes that have not been consumed yet
+    size_t produced = 0;        // total number of bytes written into the ring
+    size_t consumed = 0;        // total number of bytes released by the reader
+    size_t pending = 0;         // number of bytes handed out by the last view
+
+    std::vector<char> scratch;  // views wrapping around the end of the ring
+
+    bool finished = false;
+    bool cancelled = false;
+    std::exception_ptr error;
+
+    std::mutex mutex;
+    std::condition_variable cv_data;
+    std::condition_variable cv_space;
+    std::thread worker;
+
+public:
+    /**
+     * @brief ZstdStream constructor, starts the decompression
+     * @param data first compressed byte
+     * @param size number of compressed bytes
+     * @param source name of the source of the bytes
+     * @param capacity size of the ring buffer in bytes
+     */
+    ZstdStream(const char* _data, size_t _size, const std::string& _source, size_t capacity = 4 << 20);
+
+    /**
+     * @brief ZstdStream destructor, stops the decompression
+     */
+    ~ZstdStream();
+
+    ZstdStream(const ZstdStream&) = delete;
+    ZstdStream& operator=(const ZstdStream&) = delete;
+
+    /**
+     * @brief Read a single value and advance the stream
+     * @return value
+     */
+    template<typename T>
+    inline T read() {
+        T value;
+        std::memcpy(&value, this->view(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Copy a number of bytes and advance the stream
+     * @param dest destination
+     * @param nbytes number of bytes
+     */
+    inline void read(void* dest, size_t nbytes) {
+        if(nbytes == 0) {
+            return;
+        }
+        std::memcpy(dest, this->view(nbytes), nbytes);
+    }
+
+    /**
+     * @brief Get access to a number of bytes and advance the stream, waiting
+     *        until these have been decompressed
+     * @param nbytes number of bytes
+     * @return pointer to the first byte
+     */
+    const char* view(size_t nbytes);
+
+    /**
+     * @brief Get access to an array of fixed-size records and advance the
+     *        stream
+     * @param count number of records
+     * @param record_size number of bytes per record
+     * @return pointer to the first byte
+     */
+    const char* view(size_t count, size_t record_size);
+
+private:
+    /**
+     * @brief Decompress all bytes into the ring buffer; runs on the worker
+     *        thread
+     */
+    void decompress();
+
+    /**
+     * @brief Release the bytes handed out by the last view
+     */
+    void release();
+
+    /**
+     * @brief Wait until a number of bytes is available to the reader
+     * @param nbytes number of bytes
+     * @return number of available bytes
+     */
+    size_t wait_for_data(size_t nbytes);
+};
+
+#endif // ZSTD_STREAM_H
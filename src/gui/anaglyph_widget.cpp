@@ -40,6 +40,10 @@ int normalize_msaa_samples(int samples) {
 int normalize_sphere_tesselation_level(int level) {
     return std::clamp(level, 0, 6);
 }
+
+int normalize_unitcell_expansion(int expansion) {
+    return std::clamp(expansion, (int)ATOM_CENTRAL_UNITCELL, (int)ATOM_EXPANSION_Z);
+}
 }
 
 /**
@@ -202,6 +206,11 @@ void AnaglyphWidget::load_lighting_settings() {
     this->msaa_samples = normalize_msaa_samples(settings.value("rendering/msaa_samples", this->msaa_samples).toInt());
     this->sphere_tesselation_level = normalize_sphere_tesselation_level(
         settings.value("rendering/sphere_tesselation_level", this->sphere_tesselation_level).toInt());
+    this->atom_impostors = settings.value("rendering/atom_impostors", this->atom_impostors).toBool();
+    this->bond_impostors = settings.value("rendering/bond_impostors", this->bond_impostors).toBool();
+    this->show_unitcell = settings.value("rendering/show_unitcell", this->show_unitcell).toBool();
+    this->unitcell_expansion = normalize_unitcell_expansion(
+        settings.value("rendering/unitcell_expansion", this->unitcell_expansion).toInt());
 }
 
 /**
@@ -343,6 +352,76 @@ void AnaglyphWidget::set_sphere_tesselation_level(int tesselation_level) {
     this->update();
 }
 
+void AnaglyphWidget::set_atom_impostors(bool flag) {
+    if (this->atom_impostors == flag) {
+        return;
+    }
+
+    this->atom_impostors = flag;
+
+    QSettings settings;
+    settings.setValue("rendering/atom_impostors", this->atom_impostors);
+
+    if (this->structure_renderer) {
+        this->structure_renderer->set_atom_impostors(this->atom_impostors);
+    }
+
+    this->update();
+}
+
+void AnaglyphWidget::set_bond_impostors(bool flag) {
+    if (this->bond_impostors == flag) {
+        return;
+    }
+
+    this->bond_impostors = flag;
+
+    QSettings settings;
+    settings.setValue("rendering/bond_impostors", this->bond_impostors);
+
+    if (this->structure_renderer) {
+        this->structure_renderer->set_bond_impostors(this->bond_impostors);
+    }
+
+    this->update();
+}
+
+void AnaglyphWidget::set_show_unitcell(bool flag) {
+    if (this->show_unitcell == flag) {
+        return;
+    }
+
+    this->show_unitcell = flag;
+
+    QSettings settings;
+    settings.setValue("rendering/show_unitcell", this->show_unitcell);
+
+    if (this->structure_renderer) {
+        this->structure_renderer->set_draw_unitcell(this->show_unitcell);
+    }
+
+    this->update();
+}
+
+void AnaglyphWidget::set_unitcell_expansion(int expansion) {
+    const int normalized_expansion = normalize_unitcell_expansion(expansion);
+
+    if (this->unitcell_expansion == normalized_expansion) {
+        return;
+    }
+
+    this->unitcell_expansion = normalized_expansion;
+
+    QSettings settings;
+    settings.setValue("rendering/unitcell_expansion", this->unitcell_expansion);
+
+    if (this->structure_renderer) {
+        this->structure_renderer->set_unitcell_expansion(this->unitcell_expansion);
+    }
+
+    this->update();
+}
+
 void AnaglyphWidget::reset_lighting_settings_to_defaults() {
     const LightingSettings defaults;
 
@@ -362,6 +441,10 @@ void AnaglyphWidget::reset_lighting_settings_to_defaults() {
 
     this->set_msaa_samples(4);
     this->set_sphere_tesselation_level(4);
+    this->set_atom_impostors(false);
+    this->set_bond_impostors(false);
+    this->set_show_unitcell(true);
+    this->set_unitcell_expansion(ATOM_CENTRAL_UNITCELL);
 }
 
 
@@ -419,6 +502,10 @@ void AnaglyphWidget::initializeGL() {
     this->structure_renderer = std::make_unique<StructureRenderer>(this->scene,
                                                                    this->shader_manager);
     this->structure_renderer->set_sphere_tesselation_level(this->sphere_tesselation_level);
+    this->structure_renderer->set_atom_impostors(this->atom_impostors);
+    this->structure_renderer->set_bond_impostors(this->bond_impostors);
+    this->structure_renderer->set_draw_unitcell(this->show_unitcell);
+    this->structure_renderer->set_unitcell_expansion(this->unitcell_expansion);
 
     qDebug() << "Build Framebuffers";
     this->build_framebuffers();
@@ -752,8 +839,12 @@ void AnaglyphWidget::set_stereo(QString stereo_name) {
  */
 void AnaglyphWidget::load_shaders() {
     // create regular shaders
-    shader_manager->create_shader_program("atombond_shader", ShaderProgramType::ModelShader, ":/assets/shaders/phong.vs", ":/assets/shaders/phong.fs");
+    shader_manager->create_shader_program("atombond_shader", ShaderProgramType::AtomShader, ":/assets/shaders/atom.vs", ":/assets/shaders/phong_instanced.fs");
+    shader_manager->create_shader_program("atom_impostor_shader", ShaderProgramType::AtomImpostorShader, ":/assets/shaders/atom_impostor.vs", ":/assets/shaders/atom_impostor.fs");
+    shader_manager->create_shader_program("bond_shader", ShaderProgramType::BondShader, ":/assets/shaders/bond.vs", ":/assets/shaders/phong_instanced.fs");
     shader_manager->create_shader_program("object_shader", ShaderProgramType::ModelShader, ":/assets/shaders/phong.vs", ":/assets/shaders/phong.fs");
+    shader_manager->create_shader_program("bond_impostor_shader", ShaderProgramType::BondImpostorShader, ":/assets/shaders/bond_impostor.vs", ":/assets/shaders/bond_impostor.fs");
+    shader_manager->create_shader_program("unitcell_shader", ShaderProgramType::UnitcellShader, ":/assets/shaders/line.vs", ":/assets/shaders/line.fs");
     shader_manager->create_shader_program("axes_shader", ShaderProgramType::AxesShader, ":/assets/shaders/axes.vs", ":/assets/shaders/axes.fs");
     shader_manager->create_shader_program("silhouette_shader", ShaderProgramType::SilhouetteShader, ":/assets/shaders/silhouette.vs", ":/assets/shaders/silhouette.fs");
 
@@ -74,6 +74,10 @@ private:
     static constexpr int supersample_scale = 2;
     int msaa_samples = 4;
     int sphere_tesselation_level = 4;
+    bool atom_impostors = false;
+    bool bond_impostors = false;
+    bool show_unitcell = true;
+    int unitcell_expansion = ATOM_CENTRAL_UNITCELL;
 
     QPoint m_lastPos;
     QVector3D pan_offset = QVector3D(0.0f, 0.0f, 0.0f);
@@ -290,6 +294,54 @@ public:
         return this->sphere_tesselation_level;
     }
 
+    /**
+     * @brief Set whether atoms are rendered as ray-cast sphere impostors.
+     */
+    void set_atom_impostors(bool flag);
+
+    /**
+     * @brief Get whether atoms are rendered as ray-cast sphere impostors.
+     */
+    bool get_atom_impostors() const {
+        return this->atom_impostors;
+    }
+
+    /**
+     * @brief Set whether bonds are rendered as ray-cast cylinder impostors.
+     */
+    void set_bond_impostors(bool flag);
+
+    /**
+     * @brief Get whether bonds are rendered as ray-cast cylinder impostors.
+     */
+    bool get_bond_impostors() const {
+        return this->bond_impostors;
+    }
+
+    /**
+     * @brief Set whether the edges of the unit cell are drawn.
+     */
+    void set_show_unitcell(bool flag);
+
+    /**
+     * @brief Get whether the edges of the unit cell are drawn.
+     */
+    bool get_show_unitcell() const {
+        return this->show_unitcell;
+    }
+
+    /**
+     * @brief Set which periodic images of the unit cell are drawn.
+     */
+    void set_unitcell_expansion(int expansion);
+
+    /**
+     * @brief Get which periodic images of the unit cell are drawn.
+     */
+    int get_unitcell_expansion() const {
+        return this->unitcell_expansion;
+    }
+
     /**
      * @brief Reset all lighting settings to defaults.
      */
@@ -76,6 +76,11 @@ InterfaceWindow::InterfaceWindow(MainWindow *mw)
     qDebug() << "Build orbital widget";
     this->orbital_widget = new OrbitalWidget(this);
 
+    // the isosurface construction itself is parallelized, hence a single
+    // worker suffices to keep the interface responsive
+    this->orbital_pool.setMaxThreadCount(1);
+    this->frame_pool.setMaxThreadCount(1);
+
     // set layout
     QVBoxLayout *mainLayout = new QVBoxLayout;
     QHBoxLayout *container = new QHBoxLayout;
@@ -116,6 +121,16 @@ InterfaceWindow::InterfaceWindow(MainWindow *mw)
     connect(this->anaglyph_widget, SIGNAL(opengl_ready()), this, SLOT(load_default_file()));
 }
 
+/**
+ * @brief      Destroys the object, cancelling any orbital construction
+ */
+InterfaceWindow::~InterfaceWindow() {
+    this->cancel_orbital();
+    this->orbital_pool.waitForDone();
+    this->frame_pool.clear();
+    this->frame_pool.waitForDone();
+}
+
 /**
  * @brief Build interface to control the scene: rotate, toggle axis
  */
@@ -260,12 +275,24 @@ void InterfaceWindow::keyPressEvent(QKeyEvent *e) {
 void InterfaceWindow::open_file(const QString& filename) {
     qDebug() << "Opening file: " << filename;
 
+    // prevent a pending orbital from replacing the file
+    this->cancel_orbital();
+
+    std::shared_ptr<Container> loaded_container;
     try {
-        this->container = this->conload.load_data_abo(filename.toStdString());
+        loaded_container = this->conload.load_data_abo(filename.toStdString());
+
+        // frames may only be decoded on first access; report a corrupt file
+        // before replacing the current container
+        if(loaded_container->get_nr_frames() > 0) {
+            loaded_container->frame(0);
+        }
     } catch(const std::exception& e) {
         QMessageBox::critical(this, tr("Exception encountered"), tr(e.what()) );
         return;
     }
+    this->container = loaded_container;
+    this->orbital_widget->set_isovalue_enabled(false);
 
     if (this->container && this->container->is_neb_pathway()) {
         this->set_axes_enabled(false);
@@ -320,27 +347,136 @@ void InterfaceWindow::build_orbital(int orbid) {
     int m = ((orbid) & (0b1111)) - l;
     qDebug() << "Building atomic orbital: (" << n << "," << l << "," << m << ")";
 
-    // build orbital models
-    this->orbbuilder.build_orbital(n,l,m);
-    auto posmodel = std::make_shared<Model>(this->orbbuilder.get_pos()->get_vertices(),
-                                            this->orbbuilder.get_pos()->get_normals(),
-                                            this->orbbuilder.get_pos()->get_indices());
-    auto negmodel = std::make_shared<Model>(this->orbbuilder.get_neg()->get_vertices(),
-                                            this->orbbuilder.get_neg()->get_normals(),
-                                            this->orbbuilder.get_neg()->get_indices());
+    // abandon the orbital that is currently being built, if any
+    this->cancel_orbital();
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    this->orbital_cancelled = cancelled;
+
+    // new orbitals are shown at their default isovalue; the isovalue can
+    // only be changed once the orbital is on screen
+    this->orbital_widget->reset_isovalue();
+    this->orbital_widget->set_isovalue_enabled(false);
+
+    const QString label = QString("(%1,%2,%3)").arg(n).arg(l).arg(m);
+    this->orbital_pool.start([this, n, l, m, cancelled, label]() {
+        // report progress on the statusbar; the signal is queued to the gui thread
+        auto progress = [this, cancelled, label](OrbitalBuilder::Stage stage, unsigned int level) {
+            if(!cancelled->load()) {
+                const unsigned int gridsize = OrbitalBuilder::get_gridsize(level);
+                emit signal_message_statusbar(QString("Building orbital %1 on %2x%2x%2 grid: %3 (%4/%5)")
+                                              .arg(label)
+                                              .arg(gridsize)
+                                              .arg(OrbitalBuilder::get_stage_description(stage))
+                                              .arg((int)stage + 1)
+                                              .arg((int)OrbitalBuilder::Stage::NR_STAGES));
+            }
+        };
+
+        // hand the meshes over to the gui thread; the first meshes replace
+        // the current container and later ones refine the orbital in place
+        auto first = std::make_shared<bool>(true);
+        auto deliver = [this, cancelled, first](const std::shared_ptr<const OrbitalMeshes>& meshes) {
+            const bool refine = !*first;
+            *first = false;
+            QMetaObject::invokeMethod(this, [this, meshes, cancelled, refine]() {
+                if(!cancelled->load()) {
+                    this->load_orbital(meshes, refine);
+                }
+            }, Qt::QueuedConnection);
+        };
+
+        std::shared_ptr<const OrbitalMeshes> meshes;
+        try {
+            meshes = this->orbbuilder.build_orbital(n, l, m, cancelled.get(), progress, deliver);
+        } catch(const std::exception& e) {
+            qWarning() << "Could not build orbital" << label << ":" << e.what();
+            emit signal_message_statusbar(QString("Could not build orbital %1").arg(label));
+            return;
+        }
+
+        if(!meshes) {
+            qDebug() << "Cancelled building orbital" << label;
+            return;
+        }
+
+        deliver(meshes);
+        if(!cancelled->load()) {
+            emit signal_message_statusbar(QString("Built orbital %1").arg(label));
+        }
+    });
+}
+
+/**
+ * @brief      Re-extract the isosurfaces of the orbital shown at another
+ *             isovalue
+ *
+ * @param[in]  scale  Isovalue relative to the surface enclosing 95% of
+ *                    the probability
+ */
+void InterfaceWindow::change_orbital_isovalue(double scale) {
+    // only the latest slider position is of interest
+    this->cancel_orbital();
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    this->orbital_cancelled = cancelled;
+
+    this->orbital_pool.start([this, scale, cancelled]() {
+        std::shared_ptr<const OrbitalMeshes> meshes;
+        try {
+            meshes = this->orbbuilder.change_isovalue(scale, cancelled.get());
+        } catch(const std::exception& e) {
+            qWarning() << "Could not change isovalue:" << e.what();
+            return;
+        }
+
+        if(!meshes) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(this, [this, meshes, cancelled]() {
+            if(!cancelled->load()) {
+                this->load_orbital(meshes, true);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief      Cancel the construction of the orbital that is being built
+ */
+void InterfaceWindow::cancel_orbital() {
+    if(this->orbital_cancelled) {
+        this->orbital_cancelled->store(true);
+        this->orbital_cancelled.reset();
+    }
+}
+
+/**
+ * @brief      Load the meshes of a finished orbital
+ *
+ * @param[in]  meshes  Meshes of the positive and negative lobes
+ * @param[in]  refine  Whether the meshes refine the orbital currently shown,
+ *                     in which case the camera is left untouched
+ */
+void InterfaceWindow::load_orbital(const std::shared_ptr<const OrbitalMeshes>& meshes, bool refine) {
+    auto posmodel = std::make_shared<Model>(meshes->pos.get_vertices(),
+                                            meshes->pos.get_normals(),
+                                            meshes->pos.get_indices());
+    auto negmodel = std::make_shared<Model>(meshes->neg.get_vertices(),
+                                            meshes->neg.get_normals(),
+                                            meshes->neg.get_indices());
 
     auto orbcon = std::make_shared<Container>();
     auto frame = std::make_shared<Frame>(std::make_shared<Structure>(), "Atomic orbital");
     frame->get_structure()->add_atom(1,0,0,0);
 
     // colorizing and adding model for positive lobe (if it exists)
-    if(this->orbbuilder.get_num_pos_vertices() > 0) {
+    if(meshes->pos.get_num_vertices() > 0) {
         posmodel->set_color(QVector4D(59.2f, 79.6f, 36.9f, 100.0f) / 100.0f);
         frame->add_model(posmodel);
     }
 
     // colorizing and adding model for negative lobe (if it exists)
-    if(this->orbbuilder.get_num_neg_vertices() > 0) {
+    if(meshes->neg.get_num_vertices() > 0) {
         negmodel->set_color(QVector4D(83.1f, 32.2f, 60.4f, 100.0f) / 100.0f);
         frame->add_model(negmodel);
     }
@@ -349,7 +485,12 @@ void InterfaceWindow::build_orbital(int orbid) {
     orbcon->add_frame(frame);
 
     this->container = orbcon;
-    emit new_container_loaded();
+    if(refine) {
+        this->anaglyph_widget->set_frame(this->container->frame(this->cur_frame));
+    } else {
+        this->orbital_widget->set_isovalue_enabled(true);
+        emit new_container_loaded();
+    }
 }
 
 /**
@@ -445,9 +586,59 @@ void InterfaceWindow::handle_frame_update() {
     this->frame_slider->setTickInterval(1);
     this->frame_slider->setSliderPosition(this->cur_frame);
     this->frame_slider->setRange(0, this->max_frame - 1);
-    this->description_textfield->setText(this->container->frame(this->cur_frame)->get_description().c_str());
 
-    this->anaglyph_widget->set_frame(this->container->frame(this->cur_frame));
+    std::shared_ptr<Frame> frame;
+    try {
+        frame = this->container->frame(this->cur_frame);
+    } catch(const std::exception& e) {
+        qWarning() << "Could not load frame" << this->cur_frame << ":" << e.what();
+        emit signal_message_statusbar(QString("Could not load frame %1").arg(this->cur_frame + 1));
+        this->frame_timer->stop();
+        this->btn_frame_play->setChecked(false);
+        this->btn_frame_play->setIcon(style()->standardIcon(QStyle::SP_MediaPlay));
+        return;
+    }
+
+    this->description_textfield->setText(frame->get_description().c_str());
+    this->anaglyph_widget->set_frame(frame);
+    this->prefetch_frames();
+}
+
+/**
+ * @brief      Decode the frames following the current frame in the playback
+ *             direction on a worker thread
+ */
+void InterfaceWindow::prefetch_frames() {
+    const auto provider = this->container->get_frame_provider();
+    if(!provider) {
+        return;
+    }
+
+    std::vector<size_t> frame_ids;
+    for(int i=1; i<=frame_prefetch_count && i<this->max_frame; i++) {
+        const int frame_id = ((this->cur_frame + i * this->frame_direction) % this->max_frame + this->max_frame) % this->max_frame;
+        if(!this->container->is_materialized(frame_id)) {
+            frame_ids.push_back(frame_id);
+        }
+    }
+
+    if(frame_ids.empty()) {
+        return;
+    }
+
+    // frames requested for an earlier position of the playback head are
+    // no longer of interest
+    this->frame_pool.clear();
+    this->frame_pool.start([provider, frame_ids]() {
+        for(size_t frame_id : frame_ids) {
+            try {
+                provider->prefetch(frame_id);
+            } catch(const std::exception& e) {
+                qWarning() << "Could not prefetch frame" << frame_id << ":" << e.what();
+                return;
+            }
+        }
+    });
 }
 
 /**
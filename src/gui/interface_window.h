@@ -39,7 +39,9 @@
 #include <QInputDialog>
 #include <QComboBox>
 #include <QToolButton>
+#include <QThreadPool>
 #include <algorithm>
+#include <atomic>
 
 #include "anaglyph_widget.h"
 #include "mainwindow.h"
@@ -95,10 +97,20 @@ private:
     OrbitalBuilder orbbuilder;
     OrbitalWidget *orbital_widget;
 
+    // orbitals are built on a worker thread; a new request cancels the
+    // orbital that is still being built
+    QThreadPool orbital_pool;
+    std::shared_ptr<std::atomic<bool>> orbital_cancelled;
+
     ContainerLoader conload;
 
     std::shared_ptr<Container> container;
 
+    // frames of lazily loaded containers that follow the playback head are
+    // decoded ahead of time on a worker thread
+    static constexpr int frame_prefetch_count = 4;
+    QThreadPool frame_pool;
+
 public:
     /**
      * @brief      Constructs the object.
@@ -107,6 +119,11 @@ public:
      */
     InterfaceWindow(MainWindow *mw);
 
+    /**
+     * @brief      Destroys the object, cancelling any orbital construction
+     */
+    ~InterfaceWindow();
+
     /**
      * @brief Toggles visualization of orbital rendering menu
      */
@@ -136,6 +153,26 @@ private:
      */
     void build_sequence_interface();
 
+    /**
+     * @brief      Cancel the construction of the orbital that is being built
+     */
+    void cancel_orbital();
+
+    /**
+     * @brief      Load the meshes of a finished orbital
+     *
+     * @param[in]  meshes  Meshes of the positive and negative lobes
+     * @param[in]  refine  Whether the meshes refine the orbital currently shown,
+     *                     in which case the camera is left untouched
+     */
+    void load_orbital(const std::shared_ptr<const OrbitalMeshes>& meshes, bool refine);
+
+    /**
+     * @brief      Decode the frames following the current frame in the
+     *             playback direction on a worker thread
+     */
+    void prefetch_frames();
+
 protected:
     /**
      * @brief      Button press event
@@ -179,6 +216,15 @@ public slots:
      */
     void build_orbital(int orbid);
 
+    /**
+     * @brief      Re-extract the isosurfaces of the orbital shown at another
+     *             isovalue
+     *
+     * @param[in]  scale  Isovalue relative to the surface enclosing 95% of
+     *                    the probability
+     */
+    void change_orbital_isovalue(double scale);
+
 private slots:
     /**
      * @brief      Loads a default structure file.
@@ -0,0 +1,62 @@
+/**************************************************************************
+ *   This file is part of MANAGLYPH.                                      *
+ *                                                                        *
+ *   Author: Ivo Filot <ivo@ivofilot.nl>                                  *
+ *                                                                        *
+ *   MANAGLYPH is free software:                                          *
+ *   you can redistribute it and/or modify it under the terms of the      *
+ *   GNU General Public License as published by the Free Software         *
+ *   Foundation, either version 3 of the License, or (at your option)     *
+ *   any later version.                                                   *
+ *                                                                        *
+ *   MANAGLYPH is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty          *
+ *   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.              *
+ *   See the GNU General Public License for more details.                 *
+ *                                                                        *
+ *   You should have received a copy of the GNU General Public License    *
+ *   along with this program.  If not, see http://www.gnu.org/licenses/.  *
+ *                                                                        *
+ **************************************************************************/
+
+#ifndef LOG_MESSAGES_H
+#define LOG_MESSAGES_H
+
+#include <QString>
+#include <QStringList>
+
+#include <mutex>
+
+/**
+ * @brief Messages collected by the message handler
+ *
+ * Messages are logged from worker threads as well as from the gui thread,
+ * hence all access to the messages is guarded by a mutex.
+ */
+class LogMessages {
+private:
+    QStringList messages;
+    mutable std::mutex mutex;
+
+public:
+    /**
+     * @brief Append a message
+     * @param message message
+     */
+    inline void append(const QString& message) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->messages.append(message);
+    }
+
+    /**
+     * @brief Get the messages starting at an index
+     * @param from index of the first message
+     * @return messages
+     */
+    inline QStringList get_messages(int from = 0) const {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->messages.mid(from);
+    }
+};
+
+#endif // LOG_MESSAGES_H
@@ -22,7 +22,7 @@
 #include "../config.h"
 #include "logwindow.h"
 
-LogWindow::LogWindow(const std::shared_ptr<QStringList>& _log_messages) :
+LogWindow::LogWindow(const std::shared_ptr<const LogMessages>& _log_messages) :
     log_messages(_log_messages) {
     qDebug() << "Spawning Debug log window";
 
@@ -42,10 +42,11 @@ LogWindow::LogWindow(const std::shared_ptr<QStringList>& _log_messages) :
     this->text_box->setReadOnly(true);
     this->text_box->setOverwriteMode(false);
 
-    for(const auto& line : *this->log_messages.get()) {
+    const QStringList lines = this->log_messages->get_messages();
+    for(const auto& line : lines) {
         this->text_box->appendPlainText(line);
     }
-    this->linesread = this->log_messages->size();
+    this->linesread = lines.size();
 
     this->setMinimumHeight(256);
     this->setMinimumWidth(1024);
@@ -59,9 +60,9 @@ LogWindow::LogWindow(const std::shared_ptr<QStringList>& _log_messages) :
 }
 
 void LogWindow::update_log() {
-    int newsize = this->log_messages->size();
-    for(int i=this->linesread; i<newsize; i++) {
-        this->text_box->appendPlainText(this->log_messages->at(i));
+    const QStringList lines = this->log_messages->get_messages(this->linesread);
+    for(const auto& line : lines) {
+        this->text_box->appendPlainText(line);
     }
-    this->linesread = newsize;
+    this->linesread += lines.size();
 }
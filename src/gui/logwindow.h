@@ -31,19 +31,23 @@
 #include <QTimer>
 #include <QIcon>
 
+#include <memory>
+
+#include "log_messages.h"
+
 class LogWindow : public QWidget {
 
 Q_OBJECT
 
 private:
-    std::shared_ptr<QStringList> log_messages;
+    std::shared_ptr<const LogMessages> log_messages;
     QPlainTextEdit* text_box;
     int linesread = 0;
 
 public:
     LogWindow(){}
 
-    LogWindow(const std::shared_ptr<QStringList>& _log_messages);
+    LogWindow(const std::shared_ptr<const LogMessages>& _log_messages);
 
 private slots:
     void update_log();
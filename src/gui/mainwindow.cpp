@@ -34,7 +34,7 @@
 /**
  * @brief      Class for main window.
  */
-MainWindow::MainWindow(const std::shared_ptr<QStringList> _log_messages,
+MainWindow::MainWindow(const std::shared_ptr<LogMessages> _log_messages,
                        QWidget *parent)
     : QMainWindow(parent),
     log_messages(_log_messages) {
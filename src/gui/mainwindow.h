@@ -60,7 +60,7 @@ private:
     QTimer* statusbar_timer;
 
     // storage for log messages
-    std::shared_ptr<QStringList> log_messages;
+    std::shared_ptr<LogMessages> log_messages;
 
     // window for log messages
     std::unique_ptr<LogWindow> log_window;
@@ -70,7 +70,7 @@ public:
     /**
      * @brief      Constructs the object.
      */
-    MainWindow(const std::shared_ptr<QStringList> _log_messages,
+    MainWindow(const std::shared_ptr<LogMessages> _log_messages,
                QWidget *parent = nullptr);
 
     /**
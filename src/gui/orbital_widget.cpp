@@ -21,6 +21,9 @@
 
 #include "orbital_widget.h"
 
+#include <QSignalBlocker>
+#include <cmath>
+
 /**
  * @brief      Default constructor
  *
@@ -131,6 +134,66 @@ OrbitalWidget::OrbitalWidget(InterfaceWindow *_interfacewindow, QWidget *parent)
         ctr++;
     }
     connect(m_sigmapper, SIGNAL(mappedInt(int)), (QWidget*)this->interface_window, SLOT(build_orbital(int)));
+
+    // slider to change the isovalue of the orbital shown, from a tenth to
+    // ten times the isovalue enclosing 95% of the probability
+    parentLayout->addWidget(new QLabel("<b>Isovalue</b>"));
+    QWidget *isovalue_widget = new QWidget;
+    QHBoxLayout *isovalue_layout = new QHBoxLayout;
+    isovalue_layout->setContentsMargins(0, 0, 0, 0);
+    isovalue_widget->setLayout(isovalue_layout);
+    parentLayout->addWidget(isovalue_widget);
+
+    this->isovalue_slider = new QSlider(Qt::Horizontal);
+    this->isovalue_slider->setRange(-100, 100);
+    this->isovalue_slider->setValue(0);
+    this->isovalue_slider->setToolTip(tr("Isovalue relative to the surface enclosing 95% of the probability"));
+    this->isovalue_label = new QLabel;
+    this->isovalue_label->setMinimumWidth(40);
+    isovalue_layout->addWidget(this->isovalue_slider);
+    isovalue_layout->addWidget(this->isovalue_label);
+    this->update_isovalue_label(0);
+    this->set_isovalue_enabled(false);
+
+    connect(this->isovalue_slider, SIGNAL(valueChanged(int)), this, SLOT(handle_isovalue_slider(int)));
+    connect(this, SIGNAL(isovalue_scale_changed(double)), (QWidget*)this->interface_window, SLOT(change_orbital_isovalue(double)));
+}
+
+/**
+ * @brief      Reset the isovalue slider without emitting a change
+ */
+void OrbitalWidget::reset_isovalue() {
+    QSignalBlocker blocker(this->isovalue_slider);
+    this->isovalue_slider->setValue(0);
+    this->update_isovalue_label(0);
+}
+
+/**
+ * @brief      Set whether the isovalue can be changed
+ *
+ * @param[in]  enabled  Whether an orbital is shown
+ */
+void OrbitalWidget::set_isovalue_enabled(bool enabled) {
+    this->isovalue_slider->setEnabled(enabled);
+}
+
+/**
+ * @brief      Show the isovalue scale of a slider position
+ *
+ * @param[in]  value  The slider position
+ */
+void OrbitalWidget::update_isovalue_label(int value) {
+    this->isovalue_label->setText(QString("%1x").arg(std::pow(10.0, value / 100.0), 0, 'f', 2));
+}
+
+/**
+ * @brief      Handle movement of the isovalue slider
+ *
+ * @param[in]  value  The slider position
+ */
+void OrbitalWidget::handle_isovalue_slider(int value) {
+    this->update_isovalue_label(value);
+    emit isovalue_scale_changed(std::pow(10.0, value / 100.0));
 }
 
 /**
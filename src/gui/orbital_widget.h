@@ -30,6 +30,7 @@
 #include <QGridLayout>
 #include <QSignalMapper>
 #include <QScrollArea>
+#include <QSlider>
 
 #include <iostream>
 
@@ -42,6 +43,11 @@ private:
     QVector<QPushButton*> orbital_build_buttons;
     InterfaceWindow* interface_window;
 
+    // isovalue relative to the surface enclosing 95% of the probability, on
+    // a logarithmic scale in hundredths of a decade
+    QSlider* isovalue_slider;
+    QLabel* isovalue_label;
+
 public:
     /**
      * @brief      Default constructor
@@ -51,6 +57,18 @@ public:
      */
     OrbitalWidget(InterfaceWindow *_interfacewindow, QWidget *parent = 0);
 
+    /**
+     * @brief      Reset the isovalue slider without emitting a change
+     */
+    void reset_isovalue();
+
+    /**
+     * @brief      Set whether the isovalue can be changed
+     *
+     * @param[in]  enabled  Whether an orbital is shown
+     */
+    void set_isovalue_enabled(bool enabled);
+
 private:
     /**
      * @brief      Create a single line
@@ -59,6 +77,29 @@ private:
      */
     QFrame* create_line();
 
+    /**
+     * @brief      Show the isovalue scale of a slider position
+     *
+     * @param[in]  value  The slider position
+     */
+    void update_isovalue_label(int value);
+
+private slots:
+    /**
+     * @brief      Handle movement of the isovalue slider
+     *
+     * @param[in]  value  The slider position
+     */
+    void handle_isovalue_slider(int value);
+
+signals:
+    /**
+     * @brief      Signal that the isovalue has been changed
+     *
+     * @param[in]  scale  Isovalue relative to the surface enclosing 95% of
+     *                    the probability
+     */
+    void isovalue_scale_changed(double scale);
 };
 
 #endif // _ORBITAL_WIDGET
@@ -61,6 +61,37 @@ void ShaderProgram::add_attributes() {
             this->m_program->bindAttributeLocation("position", 0);
             this->m_program->bindAttributeLocation("normal", 1);
         break;
+        case ShaderProgramType::AtomShader:
+            this->m_program->bindAttributeLocation("position", 0);
+            this->m_program->bindAttributeLocation("normal", 1);
+            this->m_program->bindAttributeLocation("instance_position", 2);
+            this->m_program->bindAttributeLocation("instance_radius", 3);
+            this->m_program->bindAttributeLocation("instance_color", 4);
+        break;
+        case ShaderProgramType::BondShader:
+            this->m_program->bindAttributeLocation("position", 0);
+            this->m_program->bindAttributeLocation("normal", 1);
+            this->m_program->bindAttributeLocation("bond_start", 2);
+            this->m_program->bindAttributeLocation("bond_end", 3);
+            this->m_program->bindAttributeLocation("color_start", 4);
+            this->m_program->bindAttributeLocation("color_end", 5);
+        break;
+        case ShaderProgramType::AtomImpostorShader:
+            this->m_program->bindAttributeLocation("corner", 0);
+            this->m_program->bindAttributeLocation("instance_position", 2);
+            this->m_program->bindAttributeLocation("instance_radius", 3);
+            this->m_program->bindAttributeLocation("instance_color", 4);
+        break;
+        case ShaderProgramType::BondImpostorShader:
+            this->m_program->bindAttributeLocation("corner", 0);
+            this->m_program->bindAttributeLocation("bond_start", 2);
+            this->m_program->bindAttributeLocation("bond_end", 3);
+            this->m_program->bindAttributeLocation("color_start", 4);
+            this->m_program->bindAttributeLocation("color_end", 5);
+        break;
+        case ShaderProgramType::UnitcellShader:
+            this->m_program->bindAttributeLocation("position", 0);
+        break;
         default:
             // nothing to do
         break;
@@ -86,6 +117,46 @@ void ShaderProgram::add_uniforms() {
         this->uniforms.emplace("camera_mode",       this->m_program->uniformLocation("camera_mode"));
     }
 
+    if (this->type == ShaderProgramType::AtomShader ||
+        this->type == ShaderProgramType::BondShader) {
+        this->uniforms.emplace("mvp", this->m_program->uniformLocation("mvp"));
+        this->uniforms.emplace("model", this->m_program->uniformLocation("model"));
+        this->uniforms.emplace("view", this->m_program->uniformLocation("view"));
+
+        this->uniforms.emplace("light_pos",         this->m_program->uniformLocation("light_pos"));
+        this->uniforms.emplace("light_color",       this->m_program->uniformLocation("light_color"));
+        this->uniforms.emplace("diffuse_strength",  this->m_program->uniformLocation("diffuse_strength"));
+        this->uniforms.emplace("ambient_strength",  this->m_program->uniformLocation("ambient_strength"));
+        this->uniforms.emplace("specular_strength", this->m_program->uniformLocation("specular_strength"));
+        this->uniforms.emplace("shininess",         this->m_program->uniformLocation("shininess"));
+        this->uniforms.emplace("edge_strength",     this->m_program->uniformLocation("edge_strength"));
+        this->uniforms.emplace("edge_power",        this->m_program->uniformLocation("edge_power"));
+        this->uniforms.emplace("camera_mode",       this->m_program->uniformLocation("camera_mode"));
+    }
+
+    if (this->type == ShaderProgramType::BondShader ||
+        this->type == ShaderProgramType::BondImpostorShader) {
+        this->uniforms.emplace("bond_radius", this->m_program->uniformLocation("bond_radius"));
+    }
+
+    if (this->type == ShaderProgramType::AtomImpostorShader ||
+        this->type == ShaderProgramType::BondImpostorShader) {
+        this->uniforms.emplace("modelview", this->m_program->uniformLocation("modelview"));
+        this->uniforms.emplace("projection", this->m_program->uniformLocation("projection"));
+        this->uniforms.emplace("projection_inverse", this->m_program->uniformLocation("projection_inverse"));
+        this->uniforms.emplace("view", this->m_program->uniformLocation("view"));
+
+        this->uniforms.emplace("light_pos",         this->m_program->uniformLocation("light_pos"));
+        this->uniforms.emplace("light_color",       this->m_program->uniformLocation("light_color"));
+        this->uniforms.emplace("diffuse_strength",  this->m_program->uniformLocation("diffuse_strength"));
+        this->uniforms.emplace("ambient_strength",  this->m_program->uniformLocation("ambient_strength"));
+        this->uniforms.emplace("specular_strength", this->m_program->uniformLocation("specular_strength"));
+        this->uniforms.emplace("shininess",         this->m_program->uniformLocation("shininess"));
+        this->uniforms.emplace("edge_strength",     this->m_program->uniformLocation("edge_strength"));
+        this->uniforms.emplace("edge_power",        this->m_program->uniformLocation("edge_power"));
+        this->uniforms.emplace("camera_mode",       this->m_program->uniformLocation("camera_mode"));
+    }
+
     if (this->type == ShaderProgramType::StereoscopicShader) {
         this->uniforms.emplace("left_eye_texture", this->m_program->uniformLocation("left_eye_texture"));
         this->uniforms.emplace("right_eye_texture", this->m_program->uniformLocation("right_eye_texture"));
@@ -32,4 +32,8 @@ enum class ShaderProgramType {
     CanvasShader,
     PlaneShader,
     SimpleCanvasShader,
+    AtomShader,
+    BondShader,
+    AtomImpostorShader,
+    BondImpostorShader,
 };
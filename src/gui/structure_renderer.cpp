@@ -36,8 +36,16 @@ StructureRenderer::StructureRenderer(const std::shared_ptr<Scene>& _scene,
     qDebug() << "Constructing Structure Renderer object";
     this->generate_sphere_coordinates(this->sphere_tesselation_level);
     this->generate_cylinder_coordinates(2, 18);
+
+    this->vbo_atom_instances.create();
+    this->vbo_atom_instances.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    this->vbo_bond_instances.create();
+    this->vbo_bond_instances.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+
     this->load_sphere_to_vao();
     this->load_cylinder_to_vao();
+    this->load_impostors_to_vao();
+    this->load_unitcell_to_vao();
     this->load_line_to_vao();
     this->load_plane_to_vao();
 
@@ -73,11 +81,14 @@ void StructureRenderer::set_sphere_tesselation_level(unsigned int tesselation_le
  *
  * @param[in]  structure  The structure
  * @param[in]  shader     Which shader to use
+ * @param[in]  center     Centering vector of the structure
  */
 void StructureRenderer::draw_single_object(const std::shared_ptr<Model>& obj,
-                                           ShaderProgram* shader)
+                                           ShaderProgram* shader,
+                                           const QVector3D& center)
 {
     QMatrix4x4 model = (this->scene->arcball_rotation * this->scene->rotation_matrix);
+    model.translate(center);    // objects share the coordinate frame of the structure
     QMatrix4x4 mvp   = (this->scene->projection * this->scene->view) * model;
 
     shader->set_uniform("mvp", mvp);
@@ -111,11 +122,22 @@ void StructureRenderer::draw_single_object(const std::shared_ptr<Model>& obj,
  */
 void StructureRenderer::draw(const Frame *frame) {
     // draw atoms
-    this->draw_atoms(frame->get_structure().get());
+    if(this->flag_atom_impostors) {
+        this->draw_atom_impostors(frame->get_structure());
+    } else {
+        this->draw_atoms(frame->get_structure());
+    }
 
     // draw bonds
-    if(frame->get_structure().get()->get_nr_atoms() < 2000) {
-        this->draw_bonds(frame->get_structure().get());
+    if(this->flag_bond_impostors) {
+        this->draw_bond_impostors(frame->get_structure());
+    } else {
+        this->draw_bonds(frame->get_structure());
+    }
+
+    // draw unit cell
+    if(this->flag_draw_unitcell && frame->get_structure()->has_unitcell()) {
+        this->draw_unitcell(frame->get_structure());
     }
 
     auto models = frame->get_models();
@@ -150,8 +172,9 @@ void StructureRenderer::draw(const Frame *frame) {
                 (qb - scene->camera_position).lengthSquared();
         });
 
+    const QVector3D center = frame->get_structure()->get_center_vector();
     for(const auto& obj : models) {
-        draw_single_object(obj, model_shader);
+        draw_single_object(obj, model_shader, center);
     }
 
     model_shader->release();
@@ -223,58 +246,44 @@ void StructureRenderer::draw_coordinate_axes() {
 }
 
 /**
- * @brief      Draws atoms.
+ * @brief      Draws atoms using a single instanced draw call
  *
- * @param[in]  atoms           The atoms
  * @param[in]  structure       The structure
- * @param[in]  periodicity_xy  The periodicity xy
- * @param[in]  periodicity_z   The periodicity z
  */
-void StructureRenderer::draw_atoms(const Structure* structure) {
-    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+void StructureRenderer::draw_atoms(const std::shared_ptr<const Structure>& structure) {
+    this->upload_atom_instances(structure);
+    if(this->nr_atom_instances == 0) {
+        return;
+    }
+
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
 
     this->vao_sphere.bind();
 
     ShaderProgram *model_shader = this->shader_manager->get_shader_program("atombond_shader");
     model_shader->bind();
 
-    QMatrix4x4 model;
-    QMatrix4x4 mvp;
-
-    // set general properties
     model_shader->set_uniform("view", this->scene->view);
     model_shader->set_uniform("light_pos", QVector3D(0,-1000,1));
     model_shader->set_uniform("light_color", QVector3D(1,1,1));
     this->set_lighting_uniforms(model_shader, this->scene->atom_lighting);
 
-    // get the vector that positions the unitcell at the origin
-    auto ctr_vector = structure->get_center_vector();
-
-    for(const Atom& atom : structure->get_atoms()) {
-        // grab atom color
-        auto col = AtomSettings::get().get_atom_color_qvector(AtomSettings::get().get_name_from_elnr(atom.atnr));
-        QVector4D col4(col, 1.0f);
-
-        // grab atom radius
-        double radius = AtomSettings::get().get_atom_radius_from_elnr(atom.atnr);
-
-        // build model matrix
+    // draw all atoms, once for every periodic image; the per-atom
+    // translation and scaling is performed in the vertex shader using the
+    // instance data
+    for(const QVector3D& offset : this->get_image_offsets(structure)) {
+        QMatrix4x4 model;
         model.setToIdentity();
         model *= (this->scene->arcball_rotation) * (this->scene->rotation_matrix);
-        model.translate(ctr_vector);        // position the center of the unitcell at the origin
-        model.translate(atom.get_pos_qtvec());
-        model.scale(radius);
+        model.translate(structure->get_center_vector() + offset);    // position the center of the unitcell at the origin
 
         // build model - view - projection matrix
-        mvp = (this->scene->projection) * (this->scene->view) * model;
+        QMatrix4x4 mvp = (this->scene->projection) * (this->scene->view) * model;
 
-        // set per-atom properties
         model_shader->set_uniform("mvp", mvp);
         model_shader->set_uniform("model", model);
-        model_shader->set_uniform("color", col4);
 
-        // draw atom
-        f->glDrawElements(GL_TRIANGLES, this->sphere_indices.size(), GL_UNSIGNED_INT, 0);
+        f->glDrawElementsInstanced(GL_TRIANGLES, this->sphere_indices.size(), GL_UNSIGNED_INT, 0, this->nr_atom_instances);
     }
 
     this->vao_sphere.release();
@@ -282,78 +291,288 @@ void StructureRenderer::draw_atoms(const Structure* structure) {
 }
 
 /**
- * @brief      Draws bonds.
+ * @brief      Draws atoms as ray-cast sphere impostors using a single
+ *             instanced draw call
  *
- * @param[in]  structure  The structure
+ * @param[in]  structure       The structure
  */
-void StructureRenderer::draw_bonds(const Structure* structure) {
-    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+void StructureRenderer::draw_atom_impostors(const std::shared_ptr<const Structure>& structure) {
+    this->upload_atom_instances(structure);
+    if(this->nr_atom_instances == 0) {
+        return;
+    }
 
-    this->vao_cylinder.bind();
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
 
-    ShaderProgram *model_shader = this->shader_manager->get_shader_program("atombond_shader");
-    model_shader->bind();
+    this->vao_atom_impostor.bind();
 
-    QMatrix4x4 model;
-    QMatrix4x4 mvp;
+    ShaderProgram *model_shader = this->shader_manager->get_shader_program("atom_impostor_shader");
+    model_shader->bind();
 
-    // set general properties
+    // the spheres are ray-cast in eye space
+    model_shader->set_uniform("projection", this->scene->projection);
+    model_shader->set_uniform("projection_inverse", this->scene->projection.inverted());
     model_shader->set_uniform("view", this->scene->view);
     model_shader->set_uniform("light_pos", QVector3D(0,-1000,1));
     model_shader->set_uniform("light_color", QVector3D(1,1,1));
     this->set_lighting_uniforms(model_shader, this->scene->atom_lighting);
 
-    // get the vector that positions the unitcell at the origin
-    auto ctr_vector = structure->get_center_vector();
+    // draw one quad per atom for every periodic image
+    for(const QVector3D& offset : this->get_image_offsets(structure)) {
+        QMatrix4x4 model;
+        model.setToIdentity();
+        model *= (this->scene->arcball_rotation) * (this->scene->rotation_matrix);
+        model.translate(structure->get_center_vector() + offset);    // position the center of the unitcell at the origin
 
-    for(unsigned int i=0; i<structure->get_nr_bonds(); i++) {
-        const Bond& bond = structure->get_bond(i);
+        model_shader->set_uniform("modelview", this->scene->view * model);
+
+        f->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, this->nr_atom_instances);
+    }
+
+    this->vao_atom_impostor.release();
+    model_shader->release();
+}
+
+/**
+ * @brief      Upload per-atom instance data of a structure to the GPU
+ *
+ * @param[in]  structure  The structure
+ */
+void StructureRenderer::upload_atom_instances(const std::shared_ptr<const Structure>& structure) {
+    if(this->atom_instances_structure.lock() == structure) {
+        return;
+    }
+
+    const AtomSettings& atom_settings = AtomSettings::get();
+
+    std::vector<AtomInstance> instances;
+    instances.reserve(structure->get_nr_atoms());
+    for(unsigned int i=0; i<structure->get_nr_atoms(); i++) {
+        const Atom atom = structure->get_atom(i);
+        AtomInstance instance;
+        instance.position = glm::vec3(atom.x, atom.y, atom.z);
+        instance.radius = atom_settings.get_atom_radius_from_elnr(atom.atnr);
+        instance.color = atom_settings.get_atom_color_from_elnr(atom.atnr);
+        instances.push_back(instance);
+    }
 
-        QVector4D col;
+    this->vbo_atom_instances.bind();
+    this->vbo_atom_instances.allocate(instances.data(), instances.size() * sizeof(AtomInstance));
+    this->vbo_atom_instances.release();
 
+    this->nr_atom_instances = instances.size();
+    this->atom_instances_structure = structure;
+}
+
+/**
+ * @brief      Draws bonds using a single instanced draw call
+ *
+ * @param[in]  structure  The structure
+ */
+void StructureRenderer::draw_bonds(const std::shared_ptr<const Structure>& structure) {
+    this->upload_bond_instances(structure);
+    if(this->nr_bond_instances == 0) {
+        return;
+    }
+
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    this->vao_cylinder.bind();
+
+    ShaderProgram *model_shader = this->shader_manager->get_shader_program("bond_shader");
+    model_shader->bind();
+
+    model_shader->set_uniform("view", this->scene->view);
+    model_shader->set_uniform("bond_radius", 0.15f);
+    model_shader->set_uniform("light_pos", QVector3D(0,-1000,1));
+    model_shader->set_uniform("light_color", QVector3D(1,1,1));
+    this->set_lighting_uniforms(model_shader, this->scene->atom_lighting);
+
+    // draw both halves of all bonds for every periodic image; the
+    // orientation and the split into two halves is performed in the vertex
+    // shader using the instance data
+    for(const QVector3D& offset : this->get_image_offsets(structure)) {
+        QMatrix4x4 model;
         model.setToIdentity();
         model *= (this->scene->arcball_rotation) * (this->scene->rotation_matrix);
-        model.translate(ctr_vector);        // position the center of the unitcell at the origin
-        model.translate(bond.atom1.get_pos_qtvec());
-        model.rotate(qRadiansToDegrees(bond.angle), bond.axis);
-        model.scale(QVector3D(0.15, 0.15, bond.length * 0.5));
+        model.translate(structure->get_center_vector() + offset);    // position the center of the unitcell at the origin
 
         QMatrix4x4 mvp = (this->scene->projection) * (this->scene->view) * model;
 
         model_shader->set_uniform("mvp", mvp);
         model_shader->set_uniform("model", model);
-        col = QVector4D(AtomSettings::get().get_atom_color_qvector(
-            AtomSettings::get().get_name_from_elnr(bond.atom1.atnr)), 1.0f
-        );
-        model_shader->set_uniform("color", col);
 
-        // draw bond
-        f->glDrawElements(GL_TRIANGLES, this->cylinder_indices.size(), GL_UNSIGNED_INT, 0);
+        f->glDrawElementsInstanced(GL_TRIANGLES, this->cylinder_indices.size(), GL_UNSIGNED_INT, 0, 2 * this->nr_bond_instances);
+    }
 
+    this->vao_cylinder.release();
+    model_shader->release();
+}
+
+/**
+ * @brief      Draws bonds as ray-cast cylinder impostors, one quad per
+ *             bond half, using a single instanced draw call
+ *
+ * @param[in]  structure  The structure
+ */
+void StructureRenderer::draw_bond_impostors(const std::shared_ptr<const Structure>& structure) {
+    this->upload_bond_instances(structure);
+    if(this->nr_bond_instances == 0) {
+        return;
+    }
+
+    QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+    this->vao_bond_impostor.bind();
+
+    ShaderProgram *model_shader = this->shader_manager->get_shader_program("bond_impostor_shader");
+    model_shader->bind();
+
+    // the cylinders are ray-cast in eye space
+    model_shader->set_uniform("projection", this->scene->projection);
+    model_shader->set_uniform("projection_inverse", this->scene->projection.inverted());
+    model_shader->set_uniform("view", this->scene->view);
+    model_shader->set_uniform("bond_radius", 0.15f);
+    model_shader->set_uniform("light_pos", QVector3D(0,-1000,1));
+    model_shader->set_uniform("light_color", QVector3D(1,1,1));
+    this->set_lighting_uniforms(model_shader, this->scene->atom_lighting);
+
+    // draw one quad per bond half for every periodic image
+    for(const QVector3D& offset : this->get_image_offsets(structure)) {
+        QMatrix4x4 model;
         model.setToIdentity();
         model *= (this->scene->arcball_rotation) * (this->scene->rotation_matrix);
-        model.translate(ctr_vector);        // position the center of the unitcell at the origin
-        model.translate(bond.atom1.get_pos_qtvec() + (bond.direction * bond.length * 0.5));
-        model.rotate(qRadiansToDegrees(bond.angle), bond.axis);
-        model.scale(QVector3D(0.15, 0.15, bond.length * 0.5));
-
-        mvp = (this->scene->projection) * (this->scene->view) * model;
+        model.translate(structure->get_center_vector() + offset);    // position the center of the unitcell at the origin
 
-        model_shader->set_uniform("mvp", mvp);
-        model_shader->set_uniform("model", model);
-        col = QVector4D(AtomSettings::get().get_atom_color_qvector(
-            AtomSettings::get().get_name_from_elnr(bond.atom2.atnr)), 1.0f
-        );
-        model_shader->set_uniform("color", col);
+        model_shader->set_uniform("modelview", this->scene->view * model);
 
-        // draw bond
-        f->glDrawElements(GL_TRIANGLES, this->cylinder_indices.size(), GL_UNSIGNED_INT, 0);
+        f->glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, 2 * this->nr_bond_instances);
     }
 
-    this->vao_cylinder.release();
+    this->vao_bond_impostor.release();
     model_shader->release();
 }
 
+/**
+ * @brief      Upload per-bond instance data of a structure to the GPU
+ *
+ * @param[in]  structure  The structure
+ */
+void StructureRenderer::upload_bond_instances(const std::shared_ptr<const Structure>& structure) {
+    if(this->bond_instances_structure.lock() == structure) {
+        return;
+    }
+
+    const AtomSettings& atom_settings = AtomSettings::get();
+
+    std::vector<BondInstance> instances;
+    instances.reserve(structure->get_nr_bonds());
+    for(unsigned int i=0; i<structure->get_nr_bonds(); i++) {
+        const Bond bond = structure->get_bond(i);
+        const glm::vec3 start(bond.atom1.x, bond.atom1.y, bond.atom1.z);
+        const glm::vec3 end(bond.atom2.x, bond.atom2.y, bond.atom2.z);
+        const glm::vec4 color_start = atom_settings.get_atom_color_from_elnr(bond.atom1.atnr);
+        const glm::vec4 color_end = atom_settings.get_atom_color_from_elnr(bond.atom2.atnr);
+
+        const BondPair& pair = structure->get_bond_pair(i);
+        if(pair.shift[0] == 0 && pair.shift[1] == 0 && pair.shift[2] == 0) {
+            instances.push_back({start, end, color_start, color_end});
+            continue;
+        }
+
+        // a bond across a periodic boundary is drawn as the half at each of
+        // its two atoms; the halves of neighbouring periodic images meet at
+        // the middle of the bond
+        const Atom atom2 = structure->get_atom(pair.atom2);
+        const glm::vec3 origin(atom2.x, atom2.y, atom2.z);
+        instances.push_back({start, 0.5f * (start + end), color_start, color_start});
+        instances.push_back({origin, origin + 0.5f * (start - end), color_end, color_end});
+    }
+
+    this->vbo_bond_instances.bind();
+    this->vbo_bond_instances.allocate(instances.data(), instances.size() * sizeof(BondInstance));
+    this->vbo_bond_instances.release();
+
+    this->nr_bond_instances = instances.size();
+    this->bond_instances_structure = structure;
+}
+
+/**
+ * @brief      Draws the edges of the unit cell
+ *
+ * @param[in]  structure  The structure
+ */
+void StructureRenderer::draw_unitcell(const std::shared_ptr<const Structure>& structure) {
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+
+    // corners of the unit cell; bit k of the corner index denotes whether
+    // lattice vector k is added
+    std::vector<glm::vec3> vertices(8);
+    for(unsigned int i=0; i<8; i++) {
+        QVector3D corner(0.0, 0.0, 0.0);
+        for(unsigned int k=0; k<3; k++) {
+            if(i & (1 << k)) {
+                corner += structure->get_unitcell_vector(k);
+            }
+        }
+        vertices[i] = glm::vec3(corner[0], corner[1], corner[2]);
+    }
+
+    this->vao_unitcell.bind();
+    this->vbo_unitcell[0].bind();
+    this->vbo_unitcell[0].write(0, &vertices[0][0], vertices.size() * 3 * sizeof(float));
+
+    ShaderProgram *unitcell_shader = this->shader_manager->get_shader_program("unitcell_shader");
+    unitcell_shader->bind();
+
+    QMatrix4x4 model;
+    model.setToIdentity();
+    model *= (this->scene->arcball_rotation) * (this->scene->rotation_matrix);
+    model.translate(structure->get_center_vector());    // position the center of the unitcell at the origin
+
+    QMatrix4x4 mvp = (this->scene->projection) * (this->scene->view) * model;
+
+    unitcell_shader->set_uniform("mvp", mvp);
+    unitcell_shader->set_uniform("color", QVector3D(0.2f, 0.2f, 0.2f));
+
+    f->glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
+
+    this->vao_unitcell.release();
+    unitcell_shader->release();
+}
+
+/**
+ * @brief      Get the translations of the periodic images to draw
+ *
+ * @param[in]  structure  The structure
+ *
+ * @return     Translation vectors, the first being the central unit cell
+ */
+std::vector<QVector3D> StructureRenderer::get_image_offsets(const std::shared_ptr<const Structure>& structure) const {
+    std::vector<QVector3D> offsets = {QVector3D(0.0, 0.0, 0.0)};
+
+    if(!structure->has_unitcell() || this->unitcell_expansion == ATOM_CENTRAL_UNITCELL) {
+        return offsets;
+    }
+
+    const int nz = (this->unitcell_expansion == ATOM_EXPANSION_Z) ? 1 : 0;
+    for(int z=-nz; z<=nz; z++) {
+        for(int y=-1; y<=1; y++) {
+            for(int x=-1; x<=1; x++) {
+                if(x == 0 && y == 0 && z == 0) {
+                    continue;
+                }
+
+                offsets.push_back(x * structure->get_unitcell_vector(0) +
+                                  y * structure->get_unitcell_vector(1) +
+                                  z * structure->get_unitcell_vector(2));
+            }
+        }
+    }
+
+    return offsets;
+}
+
 /**
  * @brief      Set lighting uniforms.
  *
@@ -548,9 +767,70 @@ void StructureRenderer::load_sphere_to_vao() {
     this->vbo_sphere[2].bind();
     this->vbo_sphere[2].allocate(&this->sphere_indices[0], this->sphere_indices.size() * sizeof(unsigned int));
 
+    this->set_atom_instance_attributes();
+
     this->vao_sphere.release();
 }
 
+/**
+ * @brief      Load quad used for the sphere and cylinder impostors to
+ *             vertex array objects
+ */
+void StructureRenderer::load_impostors_to_vao() {
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+
+    // triangle strip covering [-1,1]^2 in counter-clockwise order
+    std::vector<glm::vec2> corners = {
+        glm::vec2(-1.0f, -1.0f),
+        glm::vec2( 1.0f, -1.0f),
+        glm::vec2(-1.0f,  1.0f),
+        glm::vec2( 1.0f,  1.0f)
+    };
+    this->vbo_impostor_quad.create();
+    this->vbo_impostor_quad.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    this->vbo_impostor_quad.bind();
+    this->vbo_impostor_quad.allocate(&corners[0][0], corners.size() * 2 * sizeof(float));
+
+    // sphere impostors
+    this->vao_atom_impostor.create();
+    this->vao_atom_impostor.bind();
+    this->vbo_impostor_quad.bind();
+    f->glEnableVertexAttribArray(0);
+    f->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    this->set_atom_instance_attributes();
+    this->vao_atom_impostor.release();
+
+    // cylinder impostors
+    this->vao_bond_impostor.create();
+    this->vao_bond_impostor.bind();
+    this->vbo_impostor_quad.bind();
+    f->glEnableVertexAttribArray(0);
+    f->glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    this->set_bond_instance_attributes();
+    this->vao_bond_impostor.release();
+}
+
+/**
+ * @brief      Set the per-instance atom attributes on the bound vertex
+ *             array object
+ */
+void StructureRenderer::set_atom_instance_attributes() {
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+    QOpenGLExtraFunctions *ef = QOpenGLContext::currentContext()->extraFunctions();
+
+    // per-instance attributes: position, radius and color of each atom
+    this->vbo_atom_instances.bind();
+    f->glEnableVertexAttribArray(2);
+    f->glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(AtomInstance), (void*)offsetof(AtomInstance, position));
+    ef->glVertexAttribDivisor(2, 1);
+    f->glEnableVertexAttribArray(3);
+    f->glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(AtomInstance), (void*)offsetof(AtomInstance, radius));
+    ef->glVertexAttribDivisor(3, 1);
+    f->glEnableVertexAttribArray(4);
+    f->glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(AtomInstance), (void*)offsetof(AtomInstance, color));
+    ef->glVertexAttribDivisor(4, 1);
+}
+
 /**
  * @brief      Load all data to a vertex array object
  */
@@ -580,9 +860,36 @@ void StructureRenderer::load_cylinder_to_vao() {
     this->vbo_cylinder[2].bind();
     this->vbo_cylinder[2].allocate(&this->cylinder_indices[0], this->cylinder_indices.size() * sizeof(unsigned int));
 
+    this->set_bond_instance_attributes();
+
     this->vao_cylinder.release();
 }
 
+/**
+ * @brief      Set the per-instance bond attributes on the bound vertex
+ *             array object
+ */
+void StructureRenderer::set_bond_instance_attributes() {
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+    QOpenGLExtraFunctions *ef = QOpenGLContext::currentContext()->extraFunctions();
+
+    // per-instance attributes: end points and colors of each bond; every
+    // bond is used for two consecutive instances, one per bond half
+    this->vbo_bond_instances.bind();
+    f->glEnableVertexAttribArray(2);
+    f->glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(BondInstance), (void*)offsetof(BondInstance, start));
+    ef->glVertexAttribDivisor(2, 2);
+    f->glEnableVertexAttribArray(3);
+    f->glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(BondInstance), (void*)offsetof(BondInstance, end));
+    ef->glVertexAttribDivisor(3, 2);
+    f->glEnableVertexAttribArray(4);
+    f->glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(BondInstance), (void*)offsetof(BondInstance, color_start));
+    ef->glVertexAttribDivisor(4, 2);
+    f->glEnableVertexAttribArray(5);
+    f->glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(BondInstance), (void*)offsetof(BondInstance, color_end));
+    ef->glVertexAttribDivisor(5, 2);
+}
+
 /**
  * @brief      Load simple line data to vertex array object
  */
@@ -610,6 +917,43 @@ void StructureRenderer::load_line_to_vao() {
     this->vao_line.release();
 }
 
+/**
+ * @brief      Load the edges of a unit cell to vertex array object
+ */
+void StructureRenderer::load_unitcell_to_vao() {
+    QOpenGLFunctions *f = QOpenGLContext::currentContext()->functions();
+
+    this->vao_unitcell.create();
+    this->vao_unitcell.bind();
+
+    // the corners are set when drawing the unit cell
+    std::vector<glm::vec3> vertices(8);
+    this->vbo_unitcell[0].create();
+    this->vbo_unitcell[0].setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    this->vbo_unitcell[0].bind();
+    this->vbo_unitcell[0].allocate(&vertices[0][0], vertices.size() * 3 * sizeof(float));
+    f->glEnableVertexAttribArray(0);
+    f->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+    // connect every pair of corners that differ by a single lattice vector
+    std::vector<unsigned int> indices;
+    for(unsigned int i=0; i<8; i++) {
+        for(unsigned int k=0; k<3; k++) {
+            if(!(i & (1 << k))) {
+                indices.push_back(i);
+                indices.push_back(i | (1 << k));
+            }
+        }
+    }
+    this->vbo_unitcell[1] = QOpenGLBuffer(QOpenGLBuffer::IndexBuffer);
+    this->vbo_unitcell[1].create();
+    this->vbo_unitcell[1].setUsagePattern(QOpenGLBuffer::StaticDraw);
+    this->vbo_unitcell[1].bind();
+    this->vbo_unitcell[1].allocate(&indices[0], indices.size() * sizeof(unsigned int));
+
+    this->vao_unitcell.release();
+}
+
 /**
  * @brief      Load simple line data to vertex array object
  */
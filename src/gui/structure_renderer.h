@@ -22,6 +22,7 @@
 #pragma once
 
 #include <QOpenGLFunctions>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLBuffer>
 #include <QDebug>
@@ -37,6 +38,8 @@
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/norm.hpp>
 
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "../data/model_loader.h"
@@ -44,6 +47,25 @@
 #include "scene.h"
 #include "shader_program_manager.h"
 
+/**
+ * @brief Per-atom data for instanced rendering of the atoms
+ */
+struct AtomInstance {
+    glm::vec3 position;
+    float radius;
+    glm::vec4 color;
+};
+
+/**
+ * @brief Per-bond data for instanced rendering of the two bond halves
+ */
+struct BondInstance {
+    glm::vec3 start;
+    glm::vec3 end;
+    glm::vec4 color_start;
+    glm::vec4 color_end;
+};
+
 class StructureRenderer {
 private:
     // sphere facets
@@ -60,9 +82,26 @@ private:
     QOpenGLVertexArrayObject vao_sphere;
     QOpenGLBuffer vbo_sphere[3];
 
+    QOpenGLBuffer vbo_atom_instances;
+
+    // screen-aligned quads for ray-cast sphere and cylinder impostors
+    QOpenGLBuffer vbo_impostor_quad;
+    QOpenGLVertexArrayObject vao_atom_impostor;
+    QOpenGLVertexArrayObject vao_bond_impostor;
+
+    // structure whose atoms currently reside in the instance buffer
+    std::weak_ptr<const Structure> atom_instances_structure;
+    unsigned int nr_atom_instances = 0;
+
     QOpenGLVertexArrayObject vao_cylinder;
     QOpenGLBuffer vbo_cylinder[3];
 
+    QOpenGLBuffer vbo_bond_instances;
+
+    // structure whose bonds currently reside in the instance buffer
+    std::weak_ptr<const Structure> bond_instances_structure;
+    unsigned int nr_bond_instances = 0;
+
     QOpenGLVertexArrayObject vao_unitcell;
     QOpenGLBuffer vbo_unitcell[2];
 
@@ -79,6 +118,10 @@ private:
     std::shared_ptr<Model> axis_model;
 
     unsigned int sphere_tesselation_level = 4;
+    bool flag_atom_impostors = false;
+    bool flag_bond_impostors = false;
+    bool flag_draw_unitcell = true;
+    int unitcell_expansion = ATOM_CENTRAL_UNITCELL;
 
 public:
     /**
@@ -107,6 +150,61 @@ public:
         return this->sphere_tesselation_level;
     }
 
+    /**
+     * @brief      Set whether atoms are drawn as ray-cast sphere impostors
+     *             instead of tesselated spheres
+     *
+     * @param[in]  flag  Whether to use impostors
+     */
+    inline void set_atom_impostors(bool flag) {
+        this->flag_atom_impostors = flag;
+    }
+
+    inline bool get_atom_impostors() const {
+        return this->flag_atom_impostors;
+    }
+
+    /**
+     * @brief      Set whether bonds are drawn as ray-cast cylinder impostors
+     *             instead of cylinder meshes
+     *
+     * @param[in]  flag  Whether to use impostors
+     */
+    inline void set_bond_impostors(bool flag) {
+        this->flag_bond_impostors = flag;
+    }
+
+    inline bool get_bond_impostors() const {
+        return this->flag_bond_impostors;
+    }
+
+    /**
+     * @brief      Set whether the edges of the unit cell are drawn
+     *
+     * @param[in]  flag  Whether to draw the unit cell
+     */
+    inline void set_draw_unitcell(bool flag) {
+        this->flag_draw_unitcell = flag;
+    }
+
+    inline bool get_draw_unitcell() const {
+        return this->flag_draw_unitcell;
+    }
+
+    /**
+     * @brief      Set which periodic images of the unit cell are drawn
+     *
+     * @param[in]  expansion  ATOM_CENTRAL_UNITCELL, ATOM_EXPANSION_XY or
+     *                        ATOM_EXPANSION_Z
+     */
+    inline void set_unitcell_expansion(int expansion) {
+        this->unitcell_expansion = expansion;
+    }
+
+    inline int get_unitcell_expansion() const {
+        return this->unitcell_expansion;
+    }
+
 private:
     /**
      * @brief      Set lighting uniforms.
@@ -116,29 +214,93 @@ private:
     void set_lighting_uniforms(ShaderProgram* shader, const LightingSettings& settings) const;
 
     /**
-     * @brief      Draws atoms.
+     * @brief      Draws atoms using a single instanced draw call
+     *
+     * @param[in]  structure       The structure
+     */
+    void draw_atoms(const std::shared_ptr<const Structure>& structure);
+
+    /**
+     * @brief      Upload per-atom instance data of a structure to the GPU
+     *
+     * The upload is skipped when the instance buffer already holds the
+     * data of this structure, such that the buffer is only filled once per
+     * frame and re-used for both eyes in stereographic rendering.
+     *
+     * @param[in]  structure  The structure
+     */
+    void upload_atom_instances(const std::shared_ptr<const Structure>& structure);
+
+    /**
+     * @brief      Draws atoms as ray-cast sphere impostors using a single
+     *             instanced draw call
      *
-     * @param[in]  atoms           The atoms
      * @param[in]  structure       The structure
-     * @param[in]  periodicity_xy  The periodicity xy
-     * @param[in]  periodicity_z   The periodicity z
      */
-    void draw_atoms(const Structure* structure);
+    void draw_atom_impostors(const std::shared_ptr<const Structure>& structure);
 
     /**
-     * @brief      Draws bonds.
+     * @brief      Set the per-instance atom attributes on the bound vertex
+     *             array object
+     */
+    void set_atom_instance_attributes();
+
+    /**
+     * @brief      Draws bonds using a single instanced draw call
      *
      * @param[in]  structure  The structure
      */
-    void draw_bonds(const Structure* structure);
+    void draw_bonds(const std::shared_ptr<const Structure>& structure);
+
+    /**
+     * @brief      Upload per-bond instance data of a structure to the GPU
+     *
+     * @param[in]  structure  The structure
+     */
+    void upload_bond_instances(const std::shared_ptr<const Structure>& structure);
+
+    /**
+     * @brief      Draws bonds as ray-cast cylinder impostors, one quad per
+     *             bond half, using a single instanced draw call
+     *
+     * @param[in]  structure  The structure
+     */
+    void draw_bond_impostors(const std::shared_ptr<const Structure>& structure);
+
+    /**
+     * @brief      Set the per-instance bond attributes on the bound vertex
+     *             array object
+     */
+    void set_bond_instance_attributes();
+
+    /**
+     * @brief      Draws the edges of the unit cell
+     *
+     * @param[in]  structure  The structure
+     */
+    void draw_unitcell(const std::shared_ptr<const Structure>& structure);
+
+    /**
+     * @brief      Get the translations of the periodic images to draw
+     *
+     * The atoms and bonds of the central unit cell are re-used for every
+     * image by repeating the instanced draw call with a translated model
+     * matrix.
+     *
+     * @param[in]  structure  The structure
+     *
+     * @return     Translation vectors, the first being the central unit cell
+     */
+    std::vector<QVector3D> get_image_offsets(const std::shared_ptr<const Structure>& structure) const;
 
     /**
      * @brief      Draw single object
      *
      * @param[in]  structure  The structure
      * @param[in]  shader     Which shader to use
+     * @param[in]  center     Centering vector of the structure
      */
-    void draw_single_object(const std::shared_ptr<Model>& obj, ShaderProgram* shader);
+    void draw_single_object(const std::shared_ptr<Model>& obj, ShaderProgram* shader, const QVector3D& center);
 
     /**
      * @brief      Generate coordinates of a sphere
@@ -160,11 +322,22 @@ private:
      */
     void load_sphere_to_vao();
 
+    /**
+     * @brief      Load quad used for the sphere and cylinder impostors to
+     *             vertex array objects
+     */
+    void load_impostors_to_vao();
+
     /**
      * @brief      Load all data to a vertex array object
      */
     void load_cylinder_to_vao();
 
+    /**
+     * @brief      Load the edges of a unit cell to vertex array object
+     */
+    void load_unitcell_to_vao();
+
     /**
      * @brief      Load simple line data to vertex array object
      */
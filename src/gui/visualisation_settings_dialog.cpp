@@ -59,13 +59,27 @@ VisualisationSettingsDialog::VisualisationSettingsDialog(AnaglyphWidget* anaglyp
     this->sphere_tesselation_spinbox = new QSpinBox();
     this->sphere_tesselation_spinbox->setRange(0, 6);
 
+    this->atom_impostors_checkbox = new QCheckBox(tr("Ray-cast atoms (impostors)"));
+    this->bond_impostors_checkbox = new QCheckBox(tr("Ray-cast bonds (impostors)"));
+
+    this->show_unitcell_checkbox = new QCheckBox(tr("Show unit cell"));
+    this->unitcell_expansion_combo = new QComboBox();
+    this->unitcell_expansion_combo->addItem(tr("Central unit cell"), ATOM_CENTRAL_UNITCELL);
+    this->unitcell_expansion_combo->addItem(tr("3x3x1 (along a and b)"), ATOM_EXPANSION_XY);
+    this->unitcell_expansion_combo->addItem(tr("3x3x3 (along a, b and c)"), ATOM_EXPANSION_Z);
+
     this->reset_lighting_button = new QPushButton(tr("Reset lighting defaults"));
 
     rendering_grid->addWidget(new QLabel(tr("MSAA samples")), 0, 0);
     rendering_grid->addWidget(this->msaa_combo, 0, 1);
     rendering_grid->addWidget(new QLabel(tr("Sphere tesselation")), 1, 0);
     rendering_grid->addWidget(this->sphere_tesselation_spinbox, 1, 1);
-    rendering_grid->addWidget(this->reset_lighting_button, 2, 0, 1, 2);
+    rendering_grid->addWidget(this->atom_impostors_checkbox, 2, 0, 1, 2);
+    rendering_grid->addWidget(this->bond_impostors_checkbox, 3, 0, 1, 2);
+    rendering_grid->addWidget(this->show_unitcell_checkbox, 4, 0, 1, 2);
+    rendering_grid->addWidget(new QLabel(tr("Periodic images")), 5, 0);
+    rendering_grid->addWidget(this->unitcell_expansion_combo, 5, 1);
+    rendering_grid->addWidget(this->reset_lighting_button, 6, 0, 1, 2);
 
     layout->addWidget(atom_group);
     layout->addWidget(object_group);
@@ -86,6 +100,10 @@ VisualisationSettingsDialog::VisualisationSettingsDialog(AnaglyphWidget* anaglyp
     connect_controls(object_controls);
     connect(this->msaa_combo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this]() { apply_settings(); });
     connect(this->sphere_tesselation_spinbox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this]() { apply_settings(); });
+    connect(this->atom_impostors_checkbox, &QCheckBox::toggled, this, [this]() { apply_settings(); });
+    connect(this->bond_impostors_checkbox, &QCheckBox::toggled, this, [this]() { apply_settings(); });
+    connect(this->show_unitcell_checkbox, &QCheckBox::toggled, this, [this]() { apply_settings(); });
+    connect(this->unitcell_expansion_combo, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, [this]() { apply_settings(); });
     connect(this->reset_lighting_button, &QPushButton::clicked, this, [this]() {
         if (this->anaglyph_widget) {
             this->anaglyph_widget->reset_lighting_settings_to_defaults();
@@ -140,6 +158,10 @@ void VisualisationSettingsDialog::apply_settings() {
     const int msaa_samples = this->msaa_combo->currentData().toInt();
     anaglyph_widget->set_msaa_samples(msaa_samples);
     anaglyph_widget->set_sphere_tesselation_level(this->sphere_tesselation_spinbox->value());
+    anaglyph_widget->set_atom_impostors(this->atom_impostors_checkbox->isChecked());
+    anaglyph_widget->set_bond_impostors(this->bond_impostors_checkbox->isChecked());
+    anaglyph_widget->set_show_unitcell(this->show_unitcell_checkbox->isChecked());
+    anaglyph_widget->set_unitcell_expansion(this->unitcell_expansion_combo->currentData().toInt());
 
     update_labels(atom_controls);
     update_labels(object_controls);
@@ -191,6 +213,27 @@ void VisualisationSettingsDialog::refresh_from_widget() {
         this->sphere_tesselation_spinbox->setValue(anaglyph_widget->get_sphere_tesselation_level());
     }
 
+    {
+        QSignalBlocker impostors_blocker(this->atom_impostors_checkbox);
+        this->atom_impostors_checkbox->setChecked(anaglyph_widget->get_atom_impostors());
+    }
+
+    {
+        QSignalBlocker impostors_blocker(this->bond_impostors_checkbox);
+        this->bond_impostors_checkbox->setChecked(anaglyph_widget->get_bond_impostors());
+    }
+
+    {
+        QSignalBlocker unitcell_blocker(this->show_unitcell_checkbox);
+        this->show_unitcell_checkbox->setChecked(anaglyph_widget->get_show_unitcell());
+    }
+
+    const int expansion_index = this->unitcell_expansion_combo->findData(anaglyph_widget->get_unitcell_expansion());
+    if (expansion_index >= 0) {
+        QSignalBlocker expansion_blocker(this->unitcell_expansion_combo);
+        this->unitcell_expansion_combo->setCurrentIndex(expansion_index);
+    }
+
     update_labels(atom_controls);
     update_labels(object_controls);
 }
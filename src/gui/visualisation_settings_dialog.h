@@ -29,6 +29,7 @@
 #include <QGroupBox>
 #include <QComboBox>
 #include <QSpinBox>
+#include <QCheckBox>
 #include <QPushButton>
 
 #include "anaglyph_widget.h"
@@ -69,5 +70,9 @@ private:
 
     QComboBox* msaa_combo = nullptr;
     QSpinBox* sphere_tesselation_spinbox = nullptr;
+    QCheckBox* atom_impostors_checkbox = nullptr;
+    QCheckBox* bond_impostors_checkbox = nullptr;
+    QCheckBox* show_unitcell_checkbox = nullptr;
+    QComboBox* unitcell_expansion_combo = nullptr;
     QPushButton* reset_lighting_button = nullptr;
 };
@@ -34,10 +34,11 @@
 #include "gui/mainwindow.h"
 #include "config.h"
 
-std::shared_ptr<QStringList> log_messages;
+std::shared_ptr<LogMessages> log_messages;
 
 /**
- * @brief custom function for storing and display messages
+ * @brief custom function for storing and display messages; may be invoked
+ *        from any thread
  * @param type
  * @param context
  * @param msg
@@ -101,7 +102,7 @@ int main(int argc, char *argv[]) {
     qRegisterMetaType<std::vector<uint8_t>>("stdvector_uint8_t");
 
     std::unique_ptr<MainWindow> mainWindow;
-    log_messages = std::make_shared<QStringList>();
+    log_messages = std::make_shared<LogMessages>();
 
     // parse command line arguments
     parser.process(app);